@@ -0,0 +1,113 @@
+#include "Geometry.h"
+#include "BVH.h"
+
+using namespace islands::geometry;
+
+namespace {
+
+// terrain-like grid of 2 * size * size triangles
+std::vector<Triangle> createTerrain(size_t size, std::mt19937& random) {
+	std::uniform_real_distribution<float> heightDist(-1.f, 1.f);
+	std::vector<float> heights((size + 1) * (size + 1));
+	for (auto& height : heights) {
+		height = heightDist(random);
+	}
+	const auto vertex = [&](size_t x, size_t z) {
+		return glm::vec3(x, heights[z * (size + 1) + x], z);
+	};
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(2 * size * size);
+	for (size_t z = 0; z < size; ++z) {
+		for (size_t x = 0; x < size; ++x) {
+			triangles.push_back({vertex(x, z), vertex(x, z + 1), vertex(x + 1, z)});
+			triangles.push_back({vertex(x + 1, z), vertex(x, z + 1), vertex(x + 1, z + 1)});
+		}
+	}
+	return triangles;
+}
+
+template <class F>
+double measure(F&& f, size_t& hits) {
+	const auto start = std::chrono::high_resolution_clock::now();
+	hits = f();
+	const auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+size_t popCount(unsigned int x) {
+	size_t count = 0;
+	for (; x; x &= x - 1) {
+		++count;
+	}
+	return count;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	const size_t terrainSize = argc > 1 ? std::stoul(argv[1]) : 256;
+	const size_t numSpheres = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+	std::mt19937 random(0);
+	const BVH bvh(createTerrain(terrainSize, random));
+
+	std::uniform_real_distribution<float> posDist(0.f, static_cast<float>(terrainSize));
+	std::uniform_real_distribution<float> heightDist(-1.5f, 1.5f);
+	std::uniform_real_distribution<float> radiusDist(0.2f, 2.f);
+	std::vector<Sphere> spheres(numSpheres);
+	for (auto& sphere : spheres) {
+		sphere = {{posDist(random), heightDist(random), posDist(random)}, radiusDist(random)};
+	}
+
+	std::cout << 2 * terrainSize * terrainSize << " triangles, "
+		<< numSpheres << " spheres" << std::endl;
+
+	// the path used before batches: one scalar test per candidate triangle
+	size_t scalarHits;
+	const auto scalarTime = measure([&] {
+		size_t hits = 0;
+		for (const auto& sphere : spheres) {
+			const auto rv = glm::vec3(sphere.radius);
+			bvh.query(AABB{sphere.center - rv, sphere.center + rv},
+				[&](const TriangleBatch& batch, const Triangle* triangles) {
+				for (size_t i = 0; i < batch.count; ++i) {
+					if (intersect(triangles[i], sphere)) {
+						++hits;
+					}
+				}
+			});
+		}
+		return hits;
+	}, scalarHits);
+
+	size_t batchHits;
+	const auto batchTime = measure([&] {
+		size_t hits = 0;
+		for (const auto& sphere : spheres) {
+			const auto rv = glm::vec3(sphere.radius);
+			bvh.query(AABB{sphere.center - rv, sphere.center + rv},
+				[&](const TriangleBatch& batch, const Triangle*) {
+				hits += popCount(intersect(batch, sphere));
+			});
+		}
+		return hits;
+	}, batchHits);
+
+	size_t mismatches = 0;
+	for (const auto& sphere : spheres) {
+		const auto rv = glm::vec3(sphere.radius);
+		bvh.query(AABB{sphere.center - rv, sphere.center + rv},
+			[&](const TriangleBatch& batch, const Triangle*) {
+			mismatches += popCount(intersect(batch, sphere) ^ intersectScalar(batch, sphere));
+		});
+	}
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "scalar: " << scalarTime << " ms, " << scalarHits << " hits" << std::endl
+		<< "batch:  " << batchTime << " ms, " << batchHits << " hits" << std::endl
+		<< "speedup: " << scalarTime / batchTime << "x, "
+		<< mismatches << " mismatching tests" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,156 @@
+#include "Chunk.h"
+#include "Physics.h"
+#include "PhysicalBody.h"
+
+using namespace islands;
+
+namespace {
+
+// live instances of the components below
+size_t numLiveComponents = 0;
+
+// projectiles that reached the target while their shooter was alive and after it was destroyed
+size_t numHits = 0, numHitsAfterShooterDied = 0;
+
+class Counted : public Component {
+public:
+	Counted() {
+		++numLiveComponents;
+	}
+	virtual ~Counted() {
+		--numLiveComponents;
+	}
+};
+
+// destroys its entity after a number of ticks, like the attacks of the enemies
+class Lifetime : public Counted {
+public:
+	using BaseComponent = Counted;
+
+	Lifetime(size_t ticks) : ticks_(ticks) {}
+
+	void update() override {
+		if (ticks_-- == 0) {
+			getEntity().destroy();
+		}
+	}
+
+private:
+	size_t ticks_;
+};
+
+// fires projectiles at a target it refers to by handle, whose callbacks refer to
+// the shooter by handle as well, since it may be destroyed before they hit
+class Shooter : public Counted {
+public:
+	using BaseComponent = Counted;
+
+	Shooter() : numTicks_(0) {}
+
+	void start() override {
+		target_ = getChunk().getEntityByName("Target")->getHandle();
+	}
+
+	void update() override {
+		if (++numTicks_ % 4 != 0) {
+			return;
+		}
+		const auto target = getChunk().getEntity(target_);
+		if (!target) {
+			return;
+		}
+
+		const auto projectile = getChunk().createEntity("Projectile");
+		projectile->setPosition(getEntity().getPosition());
+		projectile->setSelfMask(Entity::Mask::EnemyAttack);
+		projectile->setFilterMask(Entity::Mask::Player);
+		// long enough to reach the target from the circle the shooters are on
+		projectile->createComponent<Lifetime>(30);
+
+		const auto collider = projectile->createComponent<SphereCollider>(1.f);
+		const auto body = projectile->createComponent<PhysicalBody>(collider);
+		body->setReceiveGravity(false);
+		body->setGhost(true);
+		body->setVelocity(glm::normalize(target->getPosition() - getEntity().getPosition()) * 30.f);
+
+		auto& chunk = getChunk();
+		const auto shooter = getEntity().getHandle();
+		const auto projectileEntity = projectile.get();
+		collider->registerCallback([&chunk, shooter, projectileEntity](std::shared_ptr<Collider> opponent) {
+			if (!(opponent->getEntity().getSelfMask() & Entity::Mask::Player)) {
+				return;
+			}
+			++(chunk.getEntity(shooter) ? numHits : numHitsAfterShooterDied);
+			projectileEntity->destroy();
+		});
+	}
+
+private:
+	EntityHandle target_;
+	size_t numTicks_;
+};
+
+std::shared_ptr<Chunk> createChunk(const std::string& name) {
+	const auto chunk = std::make_shared<Chunk>(name);
+
+	const auto target = chunk->createEntity("Target");
+	target->setSelfMask(Entity::Mask::Player);
+	target->setFilterMask(Entity::Mask::EnemyAttack);
+	const auto targetCollider = target->createComponent<SphereCollider>(1.f);
+	target->createComponent<PhysicalBody>(targetCollider)->setReceiveGravity(false);
+
+	for (int i = 0; i < 8; ++i) {
+		const auto shooter = chunk->createEntity("Shooter");
+		shooter->setPosition({10.f * std::cos(i * 0.8f), 10.f * std::sin(i * 0.8f), 0.f});
+		shooter->setSelfMask(Entity::Mask::Enemy);
+		shooter->setFilterMask(Entity::Mask::PlayerAttack);
+		shooter->createComponent<Shooter>();
+		const auto collider = shooter->createComponent<SphereCollider>(1.f);
+		shooter->createComponent<PhysicalBody>(collider)->setReceiveGravity(false);
+	}
+	return chunk;
+}
+
+}
+
+// creates chunks, plays them for a while like GameScene does, destroys them and
+// checks that every entity and component allocated from their memory pools is gone
+int main() {
+	static constexpr size_t NUM_CHUNKS = 3;
+	static constexpr size_t NUM_TICKS = 120;
+
+	std::vector<std::shared_ptr<Chunk>> chunks;
+	std::vector<std::weak_ptr<MemoryPools>> pools;
+	for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+		chunks.emplace_back(createChunk("LeakCheckChunk" + std::to_string(i)));
+		pools.emplace_back(chunks.back()->getMemoryPools());
+	}
+
+	for (size_t i = 0; i < NUM_TICKS; ++i) {
+		for (const auto& chunk : chunks) {
+			chunk->update();
+		}
+		// the shooters of one chunk die halfway, leaving their projectiles behind
+		if (i == NUM_TICKS / 2) {
+			for (const auto& entity : chunks.front()->getEntities()) {
+				if (entity->hasComponent<Shooter>()) {
+					entity->destroy();
+				}
+			}
+		}
+	}
+	const auto numLiveWhilePlaying = numLiveComponents;
+	chunks.clear();
+
+	const auto numLeakedChunks = std::count_if(pools.begin(), pools.end(), [](const std::weak_ptr<MemoryPools>& p) {
+		return !p.expired();
+	});
+	std::cout << numHits << " hits and " << numHitsAfterShooterDied << " after the shooters died, "
+		<< numLiveWhilePlaying << " components while playing, "
+		<< numLiveComponents << " left and "
+		<< numLeakedChunks << " of " << NUM_CHUNKS << " chunks leaked after destroying them" << std::endl;
+
+	// without hits the callbacks, and what they refer to, would go untested
+	const bool hit = numHits > 0 && numHitsAfterShooterDied > 0;
+	return hit && numLeakedChunks == 0 && numLiveComponents == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,306 @@
+#include "Chunk.h"
+#include "Physics.h"
+#include "PhysicalBody.h"
+#include "System.h"
+
+using namespace islands;
+
+namespace {
+
+// collision geometry that is never drawn, so no model is needed
+class StaticShape : public CollisionShape {
+public:
+	StaticShape(std::shared_ptr<const geometry::BVH> bvh) : bvh_(bvh) {}
+
+	const geometry::AABB& getLocalAABB() override {
+		return bvh_->getBounds();
+	}
+	bool isAnimated() override {
+		return false;
+	}
+	geometry::AABB getAnimatedLocalAABB() override {
+		return bvh_->getBounds();
+	}
+	std::shared_ptr<const geometry::BVH> getCollisionBVH() override {
+		return bvh_;
+	}
+
+private:
+	std::shared_ptr<const geometry::BVH> bvh_;
+};
+
+picojson::value readJSON(const std::string& filePath) {
+	std::ifstream ifs(filePath);
+	if (!ifs) {
+		throw std::invalid_argument("cannot open " + filePath);
+	}
+	picojson::value json;
+	ifs >> json;
+	return json;
+}
+
+glm::vec3 toVec3(const picojson::value& v) {
+	const auto& obj = v.get<picojson::object>();
+	return{
+		obj.at("x").get<double>(),
+		obj.at("y").get<double>(),
+		obj.at("z").get<double>()
+	};
+}
+
+glm::quat toQuat(const picojson::value& v) {
+	const auto& obj = v.get<picojson::object>();
+	return{
+		static_cast<float>(obj.at("w").get<double>()),
+		static_cast<float>(obj.at("x").get<double>()),
+		static_cast<float>(obj.at("y").get<double>()),
+		static_cast<float>(obj.at("z").get<double>())
+	};
+}
+
+std::shared_ptr<Entity> createStageEntity(Chunk& chunk, const std::string& name) {
+	const auto entity = chunk.createEntity(name);
+	entity->setFilterMask(Entity::Mask::DynamicObject);
+	entity->setSelfMask(Entity::Mask::StageObject);
+	return entity;
+}
+
+// z-up grid of 2 * size * size triangles with random heights
+void createTerrain(Chunk& chunk, size_t size, std::mt19937& random) {
+	std::uniform_real_distribution<float> heightDist(-1.f, 1.f);
+	std::vector<float> heights((size + 1) * (size + 1));
+	for (auto& height : heights) {
+		height = heightDist(random);
+	}
+	const auto vertex = [&](size_t x, size_t y) {
+		return glm::vec3(x, y, heights[y * (size + 1) + x]);
+	};
+
+	std::vector<geometry::Triangle> triangles;
+	triangles.reserve(2 * size * size);
+	for (size_t y = 0; y < size; ++y) {
+		for (size_t x = 0; x < size; ++x) {
+			triangles.push_back({vertex(x, y), vertex(x + 1, y), vertex(x, y + 1)});
+			triangles.push_back({vertex(x + 1, y), vertex(x + 1, y + 1), vertex(x, y + 1)});
+		}
+	}
+
+	const auto shape = std::make_shared<StaticShape>(std::make_shared<geometry::BVH>(std::move(triangles)));
+	createStageEntity(chunk, "Terrain")->createComponent<MeshCollider>(shape);
+}
+
+// the stage colliders of the chunk at the origin of a level, from the files written by
+// the collision cooker since loading the meshes themselves needs the whole game
+void loadStage(Chunk& chunk, const std::string& levelFilename) {
+	static const std::string COLLISION_DIR = "asset/collision";
+
+	const auto level = readJSON(LEVEL_DIR + '/' + levelFilename);
+	std::string chunkFilename;
+	for (const auto& item : level.get("chunks").get<picojson::array>()) {
+		const auto& obj = item.get<picojson::object>();
+		const auto& coord = obj.at("coord").get<picojson::array>();
+		if (coord.at(0).get<double>() == 0 && coord.at(1).get<double>() == 0 && coord.at(2).get<double>() == 0) {
+			chunkFilename = obj.at("filename").get<std::string>();
+		}
+	}
+	if (chunkFilename.empty()) {
+		throw std::invalid_argument("no chunk at the origin of " + levelFilename);
+	}
+
+	const auto json = readJSON(LEVEL_DIR + '/' + chunkFilename);
+	for (const auto& ent : json.get("entities").get<picojson::object>()) {
+		const auto& prop = ent.second.get<picojson::object>();
+		const auto iter = prop.find("collision");
+		if (iter == prop.end() || !iter->second.is<picojson::object>()) {
+			continue;
+		}
+		const auto& collisionProp = iter->second.get<picojson::object>();
+		const auto& type = collisionProp.at("type").get<std::string>();
+		const auto filePath = COLLISION_DIR + '/' + collisionProp.at("mesh_name").get<std::string>() + ".bvh";
+		const auto file = std::make_shared<sys::MappedFile>(filePath);
+		if (!file->isOpen()) {
+			throw std::invalid_argument("cannot open " + filePath + ", run collision-cooker first");
+		}
+		const auto shape = std::make_shared<StaticShape>(std::make_shared<geometry::BVH>(
+			std::shared_ptr<const char>(file, file->getData()), file->getSize()));
+
+		const auto entity = createStageEntity(chunk, ent.first);
+		if (prop.find("position") != prop.end()) {
+			entity->setPosition(toVec3(prop.at("position")));
+		}
+		if (prop.find("quaternion") != prop.end()) {
+			entity->setQuaternion(toQuat(prop.at("quaternion")));
+		}
+		if (prop.find("scale") != prop.end()) {
+			entity->setScale(toVec3(prop.at("scale")));
+		}
+		if (type == "mesh") {
+			entity->createComponent<MeshCollider>(shape);
+		} else if (type == "wall") {
+			entity->createComponent<MeshCollider>(shape);
+			entity->setSelfMask(Entity::Mask::CollisionWall);
+		} else if (type == "floor") {
+			entity->createComponent<FloorCollider>(shape);
+		}
+	}
+}
+
+// rests a sphere on a slab until it sleeps, destroys the slab and checks that the sphere falls
+bool checkSupportRemoval() {
+	static constexpr size_t MAX_TICKS_TO_SLEEP = 600;
+	static constexpr size_t TICKS_TO_FALL = 30;
+
+	Chunk chunk("SupportChunk");
+	const auto support = createStageEntity(chunk, "Support");
+	support->createComponent<MeshCollider>(std::make_shared<StaticShape>(std::make_shared<geometry::BVH>(
+		std::vector<geometry::Triangle>{
+			{glm::vec3(-5, -5, 0), glm::vec3(5, -5, 0), glm::vec3(-5, 5, 0)},
+			{glm::vec3(5, -5, 0), glm::vec3(5, 5, 0), glm::vec3(-5, 5, 0)}})));
+
+	const auto sphere = chunk.createEntity("Sphere");
+	sphere->setPosition({0, 0, 1.f});
+	sphere->setSelfMask(Entity::Mask::Enemy);
+	sphere->setFilterMask(Entity::Mask::StaticObject);
+	const auto body = sphere->createComponent<PhysicalBody>(sphere->createComponent<SphereCollider>(0.5f));
+
+	for (size_t i = 0; i < MAX_TICKS_TO_SLEEP && !body->isSleeping(); ++i) {
+		chunk.update();
+	}
+	if (!body->isSleeping()) {
+		std::cerr << "support: the sphere never fell asleep" << std::endl;
+		return false;
+	}
+
+	const auto restingZ = sphere->getPosition().z;
+	support->destroy();
+	for (size_t i = 0; i < TICKS_TO_FALL; ++i) {
+		chunk.update();
+	}
+	const auto fallen = restingZ - sphere->getPosition().z;
+	std::cout << "support: the sphere fell " << fallen << " units after its support was destroyed" << std::endl;
+	return fallen > 1.f;
+}
+
+double getPercentile(const std::vector<double>& sorted, double p) {
+	const auto index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+	return sorted.at(index);
+}
+
+std::vector<size_t> parseCounts(const std::string& str) {
+	std::vector<size_t> counts;
+	std::istringstream iss(str);
+	std::string item;
+	while (std::getline(iss, item, ',')) {
+		counts.emplace_back(std::stoul(item));
+	}
+	return counts;
+}
+
+struct Result {
+	physics::Statistics last;
+	std::vector<double> sortedStepTimes; // in ns
+	double candidatePairs, narrowphaseTests, contacts; // per step
+};
+
+Result run(const std::string& stage, size_t numSpheres, size_t numTicks, float radius) {
+	std::mt19937 random(0);
+	Chunk chunk("BenchChunk");
+	if (stage == "terrain") {
+		createTerrain(chunk, 64, random);
+	} else {
+		loadStage(chunk, stage);
+	}
+
+	// one step places the static colliders so that their bounds are known
+	physics::update(chunk);
+	auto bounds = chunk.getBroadphase().getBounds();
+	if (glm::any(glm::greaterThan(bounds.min, bounds.max))) {
+		bounds = {glm::vec3(-25.f), glm::vec3(25.f)};
+	}
+
+	std::uniform_real_distribution<float> xDist(bounds.min.x, bounds.max.x);
+	std::uniform_real_distribution<float> yDist(bounds.min.y, bounds.max.y);
+	std::uniform_real_distribution<float> zDist(bounds.max.z, bounds.max.z + 10.f);
+	for (size_t i = 0; i < numSpheres; ++i) {
+		const auto entity = chunk.createEntity("BenchSphere" + std::to_string(i));
+		entity->setPosition({xDist(random), yDist(random), zDist(random)});
+		entity->setSelfMask(Entity::Mask::Enemy);
+		entity->setFilterMask(Entity::Mask::StaticObject | Entity::Mask::Enemy);
+
+		const auto collider = entity->createComponent<SphereCollider>(radius);
+		entity->createComponent<PhysicalBody>(collider);
+	}
+
+	Result result{};
+	result.sortedStepTimes.reserve(numTicks);
+	for (size_t i = 0; i < numTicks; ++i) {
+		const auto start = std::chrono::high_resolution_clock::now();
+		physics::update(chunk);
+		const auto end = std::chrono::high_resolution_clock::now();
+		result.sortedStepTimes.emplace_back(std::chrono::duration<double, std::nano>(end - start).count());
+
+		const auto& statistics = physics::getLastStatistics();
+		result.candidatePairs += statistics.numCandidatePairs;
+		result.narrowphaseTests += statistics.numNarrowphaseTests;
+		result.contacts += statistics.numContacts;
+	}
+	std::sort(result.sortedStepTimes.begin(), result.sortedStepTimes.end());
+
+	const auto n = static_cast<double>(std::max<size_t>(numTicks, 1));
+	result.candidatePairs /= n;
+	result.narrowphaseTests /= n;
+	result.contacts /= n;
+	result.last = physics::getLastStatistics();
+	return result;
+}
+
+}
+
+// steps physics on a chunk without a window, GL context or audio device.
+// "terrain" generates the stage, otherwise the stage of the chunk at the origin
+// of the level is read from asset/, so run it from the directory containing asset/.
+// spheres is a comma-separated list of counts, each run on a fresh chunk.
+// "support" instead checks that sleeping bodies fall when their support goes away
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "usage: " << argv[0] << " (terrain | level.json) [spheres=100,200,400,800,1600] [ticks=600] [tick_rate=60] [radius=0.5]" << std::endl
+			<< "       " << argv[0] << " support" << std::endl;
+		return 1;
+	}
+	const std::string stage = argv[1];
+	if (stage == "support") {
+		return checkSupportRemoval() ? 0 : 1;
+	}
+	const auto sphereCounts = parseCounts(argc > 2 ? argv[2] : "100,200,400,800,1600");
+	const size_t numTicks = argc > 3 ? std::stoul(argv[3]) : 600;
+	const float tickRate = argc > 4 ? std::stof(argv[4]) : 60.f;
+	const float radius = argc > 5 ? std::stof(argv[5]) : 0.5f;
+	if (numTicks == 0) {
+		std::cerr << "ticks must be positive" << std::endl;
+		return 1;
+	}
+
+	physics::setTickRate(tickRate);
+	std::cout << numTicks << " ticks at " << tickRate << " Hz, ns per step and counts per step" << std::endl
+		<< std::setw(9) << "colliders" << std::setw(8) << "bodies" << std::setw(9) << "sleeping"
+		<< std::setw(11) << "min" << std::setw(11) << "median" << std::setw(11) << "p99"
+		<< std::setw(10) << "pairs" << std::setw(10) << "tests" << std::setw(10) << "contacts" << std::endl;
+
+	for (const auto numSpheres : sphereCounts) {
+		const auto result = run(stage, numSpheres, numTicks, radius);
+		const auto& times = result.sortedStepTimes;
+		std::cout << std::fixed << std::setprecision(0)
+			<< std::setw(9) << result.last.numColliders
+			<< std::setw(8) << result.last.numBodies
+			<< std::setw(9) << result.last.numSleepingBodies
+			<< std::setw(11) << times.front()
+			<< std::setw(11) << getPercentile(times, 0.5)
+			<< std::setw(11) << getPercentile(times, 0.99)
+			<< std::setprecision(1)
+			<< std::setw(10) << result.candidatePairs
+			<< std::setw(10) << result.narrowphaseTests
+			<< std::setw(10) << result.contacts << std::endl;
+	}
+
+	return 0;
+}
@@ -14,6 +14,7 @@ public:
 
 	static AssetArchive& getInstance();
 
+	bool exists(const std::string& filename) const;
 	std::vector<char> readFile(const std::string& filename) const;
 	std::string readTextFile(const std::string& filename) const;
 
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Geometry.h"
+
+namespace islands {
+namespace geometry {
+
+// bounding volume hierarchy over a static triangle soup
+class BVH {
+public:
+	BVH(std::vector<Triangle> triangles);
+
+	// uses a blob written by write() in place, the blob must stay alive with the BVH.
+	// throws std::invalid_argument if the blob is not a well-formed BVH
+	BVH(std::shared_ptr<const char> blob, size_t size);
+
+	BVH(const BVH&) = delete;
+	BVH& operator=(const BVH&) = delete;
+	virtual ~BVH() = default;
+
+	const AABB& getBounds() const;
+	std::uint32_t getNumNodes() const;
+
+	// sourceChecksum identifies the file the triangles came from, see calculateChecksum().
+	// the BVH must not be empty, since the constructor above rejects empty blobs
+	void write(std::ostream& os, std::uint64_t sourceChecksum) const;
+
+	// of the blob this was loaded from, 0 if built from triangles
+	std::uint64_t getSourceChecksum() const;
+
+	// calls callback(batch, triangles) for every leaf overlapping aabb,
+	// where triangles points to batch.count triangles
+	template <class Callback>
+	void query(const AABB& aabb, Callback&& callback) const;
+
+private:
+	static constexpr std::uint32_t MAX_LEAF_SIZE = TriangleBatch::SIZE;
+	static constexpr size_t MAX_QUERY_STACK_SIZE = 64;
+
+	struct Node {
+		AABB aabb;
+
+		// leaf: batches_[first] holding count triangles
+		// inner: left child is next to this node, right child is nodes_[first]
+		std::uint32_t first, count;
+	};
+
+	// point into either the storage below or the blob
+	const Node* nodes_;
+	const TriangleBatch* batches_;
+	const Triangle* triangles_; // triangles of batches_[i] start at triangles_[i * TriangleBatch::SIZE]
+	std::uint32_t numNodes_, numBatches_;
+	std::uint64_t sourceChecksum_;
+
+	std::vector<Node> nodeStorage_;
+	std::vector<TriangleBatch> batchStorage_;
+	std::vector<Triangle> triangleStorage_;
+	std::shared_ptr<const char> blob_;
+
+	void build(std::vector<Triangle>& triangles, std::uint32_t nodeIndex, std::uint32_t begin, std::uint32_t end);
+
+	// throws std::invalid_argument unless query() stays within nodes_, batches_ and its stack
+	void validate() const;
+};
+
+// FNV-1a, to tell whether the source of a cooked BVH changed since it was written
+std::uint64_t calculateChecksum(const void* data, size_t size);
+
+template <class Callback>
+inline void BVH::query(const AABB& aabb, Callback&& callback) const {
+	if (numNodes_ == 0) {
+		return;
+	}
+
+	std::uint32_t stack[MAX_QUERY_STACK_SIZE];
+	size_t top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		const auto& node = nodes_[stack[--top]];
+		if (!intersect(node.aabb, aabb)) {
+			continue;
+		}
+		if (node.count > 0) {
+			callback(batches_[node.first], triangles_ + node.first * TriangleBatch::SIZE);
+		} else {
+			assert(top + 2 <= MAX_QUERY_STACK_SIZE);
+			stack[top++] = node.first;
+			stack[top++] = static_cast<std::uint32_t>(&node - nodes_) + 1;
+		}
+	}
+}
+
+}
+}
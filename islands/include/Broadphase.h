@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Collision.h"
+
+namespace islands {
+namespace physics {
+
+// sweep and prune along x axis
+class Broadphase {
+public:
+	using Pair = std::pair<size_t, size_t>;
+
+	Broadphase();
+	virtual ~Broadphase() = default;
+
+	// colliders of the step, filled in by the caller before update(),
+	// kept here so that the list and its capacity carry over to the next step
+	std::vector<std::shared_ptr<Collider>>& getColliders();
+
+	void update();
+
+	// indices into getColliders() as of the last update(), each pair appears once
+	const std::vector<Pair>& getPairs() const;
+
+	// calls callback for every collider whose broadphase AABB overlaps aabb,
+	// as of the last update()
+	template <class Callback>
+	void query(const geometry::AABB& aabb, Callback&& callback) const;
+
+	// bounds of all colliders except unbounded ones such as planes
+	const geometry::AABB& getBounds() const;
+
+private:
+	// wider colliders, typically the terrain and walls of the chunk, are kept out of the
+	// sorted range query() scans, which would otherwise have to start this much earlier
+	static constexpr float MAX_SCANNED_WIDTH = 16.f;
+
+	struct Endpoint {
+		float min, max;
+		size_t index;
+		bool wide;
+
+		// of the collider, looked up once here so that the sweep only tests bits
+		Collider::TypeMask type, pairableTypes;
+	};
+
+	std::vector<std::shared_ptr<Collider>> colliders_;
+	std::vector<geometry::AABB> aabbs_;
+	std::vector<Endpoint> endpoints_;
+	std::vector<size_t> wide_; // unbounded or wider than MAX_SCANNED_WIDTH, tested one by one
+	std::vector<Pair> pairs_;
+	geometry::AABB bounds_;
+	float maxScannedWidth_;
+};
+
+template <class Callback>
+inline void Broadphase::query(const geometry::AABB& aabb, Callback&& callback) const {
+	for (const auto index : wide_) {
+		if (geometry::intersect(aabbs_[index], aabb)) {
+			callback(colliders_[index]);
+		}
+	}
+
+	// no scanned endpoint starting before this can reach aabb
+	const auto begin = std::lower_bound(endpoints_.begin(), endpoints_.end(), aabb.min.x - maxScannedWidth_,
+		[](const Endpoint& endpoint, float x) {
+		return endpoint.min < x;
+	});
+	for (auto iter = begin; iter != endpoints_.end() && iter->min <= aabb.max.x; ++iter) {
+		if (!iter->wide && geometry::intersect(aabbs_[iter->index], aabb)) {
+			callback(colliders_[iter->index]);
+		}
+	}
+}
+
+}
+}
@@ -4,35 +4,91 @@
 #include "Entity.h"
 #include "Geometry.h"
 #include "Sound.h"
+#include "ContactCache.h"
+#include "Broadphase.h"
+#include "TransformStore.h"
 
 namespace islands {
 
 static const std::string LEVEL_DIR = "asset/level";
 
+// populated by loadChunk() in ChunkLoader.h or directly through createEntity()
 class Chunk : public Resource {
 public:
+	struct RaycastHit {
+		std::shared_ptr<Collider> collider;
+		float distance;
+	};
+
 	Chunk(const std::string& filename);
 	virtual ~Chunk() = default;
 
 	void update();
+	void interpolate(float alpha);
 	void draw();
 
-	std::shared_ptr<Entity> createEntity(const std::string& name);
-	const std::list<std::shared_ptr<Entity>>& getEntities() const;
-	std::shared_ptr<Entity> getEntityByName(const std::string& name) const;
+	std::shared_ptr<Entity> createEntity(const Name& name);
+
+	// in creation order, may include destroyed entities until they are cleaned
+	const std::vector<std::shared_ptr<Entity>>& getEntities() const;
+
+	// any of the entities if several share the name
+	std::shared_ptr<Entity> getEntityByName(const Name& name) const;
 
+	// nullptr if the entity has been destroyed
+	std::shared_ptr<Entity> getEntity(EntityHandle handle) const;
+
+	// bounds of the static mesh colliders, kept up to date as they are added, moved or removed
 	const geometry::AABB& getGlobalAABB() const;
+	void updateStaticBounds(const Collider& collider, const geometry::AABB& aabb);
+	void removeStaticBounds(const Collider& collider);
+	physics::ContactCache& getContactCache();
+	physics::Broadphase& getBroadphase();
+	TransformStore& getTransforms();
+	UpdateScheduler& getUpdateScheduler();
+
+	// drawables are sorted into the opaque or transparent pass on the next draw,
+	// and again after invalidateDrawable(). the transparent pass is drawn back to front
+	void addDrawable(std::shared_ptr<Drawable> drawable);
+	void invalidateDrawable(const Drawable& drawable);
 
+	// entities and their components are allocated from these
+	std::shared_ptr<MemoryPools> getMemoryPools() const;
+
+	// queries over the colliders as of the last physics step,
+	// only entities whose self mask has any bit of mask are considered
+	bool raycast(const geometry::Ray& ray, Entity::MaskType mask, RaycastHit& hit) const;
+	std::vector<std::shared_ptr<Collider>> overlapSphere(const geometry::Sphere& sphere, Entity::MaskType mask) const;
+
+	// entities with colliders, nearest first by the distance to their broadphase AABBs
+	std::vector<std::shared_ptr<Entity>> findNearestEntities(const glm::vec3& point, size_t count, Entity::MaskType mask) const;
+
+	void setCameraOffset(float offset);
+	void setBGM(std::shared_ptr<Sound> bgm);
 	std::shared_ptr<Sound> getBGM() const;
 
 private:
+	std::shared_ptr<MemoryPools> memoryPools_;
 	float cameraOffset_;
 	std::shared_ptr<Sound> bgm_;
 	geometry::AABB aabb_;
-	std::list<std::shared_ptr<Entity>> entities_;
+	std::unordered_map<const Collider*, geometry::AABB> staticBounds_;
+
+	// declared before entities_ so that it outlives them
+	TransformStore transforms_;
+	UpdateScheduler updateScheduler_;
+	SlotMap<std::shared_ptr<Entity>> entities_;
+	std::vector<std::shared_ptr<Drawable>> opaqueDrawables_, transparentDrawables_, unsortedDrawables_;
+
+	// refers to the entities in entities_ and is updated as they are created and cleaned
+	std::unordered_multimap<Name, Entity*> entitiesByName_;
+	physics::ContactCache contactCache_;
+	physics::Broadphase broadphase_;
 
-	void loadImpl() override;
 	void cleanEntities();
+	void sortDrawables();
+	void drawAndCleanDrawables(std::vector<std::shared_ptr<Drawable>>& drawables);
+	void rebuildGlobalAABB();
 };
 
 }
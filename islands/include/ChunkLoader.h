@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Chunk.h"
+
+namespace islands {
+
+// creates the player and the entities described by a chunk file in LEVEL_DIR
+void loadChunk(Chunk& chunk, const std::string& filename);
+
+}
@@ -1,134 +1,185 @@
 #pragma once
 
 #include "Component.h"
-#include "Model.h"
+#include "CollisionShape.h"
 #include "Geometry.h"
 
 namespace islands {
 
-class AABBCollider;
-class SphereCollider;
-class PlaneCollider;
-class MeshCollider;
-
 class Collider : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Physics;
+
 	using Callback = std::function<void(std::shared_ptr<Collider>)>;
 
-	Collider();
-	Collider(std::shared_ptr<Model> model);
+	using ContactEventMask = std::uint8_t;
+	enum ContactEvent : ContactEventMask {
+		Enter = 1 << 0, // first step of an overlap
+		Stay  = 1 << 1, // following steps while still overlapping
+		Exit  = 1 << 2, // first step after the overlap ended
+		Touching = Enter | Stay
+	};
+
+	enum class Type {
+		AABB,
+		Sphere,
+		Plane,
+		Mesh,
+		Capsule,
+		NumTypes
+	};
+
+	Collider(Type type);
+	Collider(Type type, std::shared_ptr<CollisionShape> shape);
 	virtual ~Collider() = default;
 
-	void registerCallback(const Callback& callback);
+	// colliders are numbered in the order they are created, which unlike their addresses
+	// is the same in every run, so that contacts can be ordered by it
+	using Serial = std::uint64_t;
+	Serial getSerial() const;
+
+	Type getType() const;
+
+	// bit i stands for the i-th Type
+	using TypeMask = std::uint32_t;
+	static TypeMask getTypeBit(Type type) {
+		return TypeMask(1) << static_cast<size_t>(type);
+	}
+
+	// types which have a narrowphase kernel with the given one, fixed at compile time.
+	// Broadphase only pairs colliders whose types are in each other's masks
+	static TypeMask getPairableTypes(Type type);
+
+	void registerCallback(const Callback& callback, ContactEventMask events = ContactEvent::Touching);
 	void clearCallbacks();
-	void notifyCollision(std::shared_ptr<Collider> opponent) const;
-	bool hasModel() const;
+	void notifyCollision(std::shared_ptr<Collider> opponent, ContactEvent event) const;
+	bool hasShape() const;
 	void setDynamicAABB(bool dynamic);
 	const geometry::AABB& getGlobalAABB() const;
+	virtual geometry::AABB getBroadphaseAABB() const;
 	void setGhost(bool isGhost);
 	bool isGhost() const;
 
 	virtual void update() override;
 	virtual glm::vec3 getNormal(const glm::vec3& refPos) const = 0;
 
-	glm::vec3 getSinkageCorrector(std::shared_ptr<Collider> collider) const;
-	bool intersects(std::shared_ptr<Collider>) const;
+	// scene queries against the shape as of the last update()
+	virtual bool raycast(const geometry::Ray& ray, float& distance) const = 0;
+	virtual bool overlapsSphere(const geometry::Sphere& sphere) const = 0;
+
+	// hits are the triangles the overlap test of the two colliders found
+	glm::vec3 getSinkageCorrector(const Collider& collider, const geometry::MeshHits& hits) const;
+	bool intersects(const Collider& collider) const;
+
+	// intersection test ignoring masks, false for types that cannot be paired
+	bool overlaps(const Collider& collider) const;
+
+	// also collects the triangles hit when one of them is a MeshCollider
+	bool overlaps(const Collider& collider, geometry::MeshHits& hits) const;
 
 protected:
 	geometry::AABB globalAABB_;
 
-	std::shared_ptr<Model> getModel() const;
+	std::shared_ptr<CollisionShape> getShape() const;
 
-	virtual bool intersectsImpl(std::shared_ptr<AABBCollider>) const {
-		throw std::exception("not implemented");
-	}
-	virtual bool intersectsImpl(std::shared_ptr<SphereCollider>) const {
-		throw std::exception("not implemented");
-	}
-	virtual bool intersectsImpl(std::shared_ptr<PlaneCollider>) const {
-		throw std::exception("not implemented");
-	}
-	virtual bool intersectsImpl(std::shared_ptr<MeshCollider>) const {
-		throw std::exception("not implemented");
-	}
+	// whether the last update() saw a transform change or an animated AABB
+	bool isShapeChanged() const;
 
-	virtual float getSinkage(std::shared_ptr<AABBCollider>) const {
-		throw std::exception("not implemented");
-	}
-	virtual float getSinkage(std::shared_ptr<SphereCollider>) const {
-		throw std::exception("not implemented");
-	}
-	virtual float getSinkage(std::shared_ptr<PlaneCollider>) const {
-		throw std::exception("not implemented");
-	}
-	virtual float getSinkage(std::shared_ptr<MeshCollider>) const {
-		throw std::exception("not implemented");
-	}
+	// false until the first update(), and again after setDynamicAABB()
+	bool isUpdated() const;
 
 private:
-	std::shared_ptr<Model> model_;
+	const Serial serial_;
+	const Type type_;
+	std::shared_ptr<CollisionShape> shape_;
 	bool dynamicAABB_;
-	std::vector<Callback> callbacks_;
+	std::vector<std::pair<Callback, ContactEventMask>> callbacks_;
 	bool isGhost_;
+	bool updated_, shapeChanged_;
+	Entity::TransformVersion transformVersion_;
 };
 
 class AABBCollider : public Collider {
 public:
-	using Collider::Collider;
+	using BaseComponent = Collider;
+
+	AABBCollider();
+	AABBCollider(std::shared_ptr<CollisionShape> shape);
 	virtual ~AABBCollider() = default;
 
 	glm::vec3 getNormal(const glm::vec3&) const override {
-		throw std::exception("not implemented");
+		throw std::logic_error("not implemented");
 	}
-
-private:
-	bool intersectsImpl(std::shared_ptr<AABBCollider>) const override;
+	bool raycast(const geometry::Ray& ray, float& distance) const override;
+	bool overlapsSphere(const geometry::Sphere& sphere) const override;
 };
 
 class SphereCollider : public Collider {
 public:
-	SphereCollider(std::shared_ptr<Model> model);
-	SphereCollider(std::shared_ptr<Model> model, float radius);
+	using BaseComponent = Collider;
+
+	SphereCollider(std::shared_ptr<CollisionShape> shape);
+	SphereCollider(std::shared_ptr<CollisionShape> shape, float radius);
 	SphereCollider(float radius);
 	virtual ~SphereCollider() = default;
 
 	void update() override;
 	glm::vec3 getNormal(const glm::vec3& refPos) const override;
+	bool raycast(const geometry::Ray& ray, float& distance) const override;
+	bool overlapsSphere(const geometry::Sphere& sphere) const override;
+	geometry::AABB getBroadphaseAABB() const override;
 	const geometry::Sphere& getGlobalSphere() const;
 
 private:
 	bool radiusFixed_;
 	geometry::Sphere globalSphere_;
+};
+
+// capsule along the longest axis of the shape's local AABB
+class CapsuleCollider : public Collider {
+public:
+	using BaseComponent = Collider;
+
+	CapsuleCollider(std::shared_ptr<CollisionShape> shape);
+	virtual ~CapsuleCollider() = default;
 
-	bool intersectsImpl(std::shared_ptr<SphereCollider>) const override;
-	bool intersectsImpl(std::shared_ptr<PlaneCollider>) const override;
-	bool intersectsImpl(std::shared_ptr<MeshCollider>) const override;
-	float getSinkage(std::shared_ptr<SphereCollider>) const override;
-	float getSinkage(std::shared_ptr<PlaneCollider>) const override;
+	void update() override;
+	glm::vec3 getNormal(const glm::vec3& refPos) const override;
+	bool raycast(const geometry::Ray& ray, float& distance) const override;
+	bool overlapsSphere(const geometry::Sphere& sphere) const override;
+	geometry::AABB getBroadphaseAABB() const override;
+	const geometry::Capsule& getGlobalCapsule() const;
+
+private:
+	geometry::Capsule localCapsule_, globalCapsule_;
+	glm::length_t axis_;
 };
 
 class PlaneCollider : public Collider {
 public:
-	PlaneCollider(std::shared_ptr<Model> model, const glm::vec3& normal);
+	using BaseComponent = Collider;
+
+	PlaneCollider(std::shared_ptr<CollisionShape> shape, const glm::vec3& normal);
 	virtual ~PlaneCollider() = default;
 
 	void update() override;
 	glm::vec3 getNormal(const glm::vec3& refPos) const override;
+	bool raycast(const geometry::Ray& ray, float& distance) const override;
+	bool overlapsSphere(const geometry::Sphere& sphere) const override;
+	geometry::AABB getBroadphaseAABB() const override;
 	const geometry::Plane& getGlobalPlane() const;
 	void setOffset(float offset);
 
 protected:
 	geometry::Plane globalPlane_;
 	float offset_;
-
-private:
-	bool intersectsImpl(std::shared_ptr<SphereCollider>) const override;
-	float getSinkage(std::shared_ptr<SphereCollider>) const override;
 };
 
 class FloorCollider : public PlaneCollider {
 public:
-	FloorCollider(std::shared_ptr<Model> model);
+	using BaseComponent = PlaneCollider;
+
+	FloorCollider(std::shared_ptr<CollisionShape> shape);
 	virtual ~FloorCollider() = default;
 
 	void update() override;
@@ -136,18 +187,27 @@ public:
 
 class MeshCollider : public Collider {
 public:
-	MeshCollider(std::shared_ptr<Model> model);
+	using BaseComponent = Collider;
+
+	MeshCollider(std::shared_ptr<CollisionShape> shape);
 	virtual ~MeshCollider() = default;
 
 	void update() override;
-	glm::vec3 getNormal(const glm::vec3& refPos) const override;
-	geometry::CollisionMesh& getCollisionMesh() const;
 
-private:
-	mutable geometry::CollisionMesh collisionMesh_;
+	// depends on where it is touched, see getSinkageCorrector()
+	glm::vec3 getNormal(const glm::vec3&) const override {
+		throw std::logic_error("not implemented");
+	}
+	bool raycast(const geometry::Ray& ray, float& distance) const override;
+	bool overlapsSphere(const geometry::Sphere& sphere) const override;
+	const geometry::CollisionMesh& getCollisionMesh() const;
 
-	bool intersectsImpl(std::shared_ptr<SphereCollider>) const override;
-	float getSinkage(std::shared_ptr<SphereCollider>) const override;
+	// adds the bounds to those of the chunk if the entity is a StaticObject, removes them otherwise.
+	// called when the shape changes and by Entity::setSelfMask when the mask flips
+	void updateStaticBounds();
+
+private:
+	geometry::CollisionMesh collisionMesh_;
 };
 
 }
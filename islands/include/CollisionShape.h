@@ -0,0 +1,23 @@
+#pragma once
+
+#include "BVH.h"
+
+namespace islands {
+
+// the geometry colliders are fitted to, implemented by Model,
+// so that colliders do not depend on how the geometry is loaded or drawn
+class CollisionShape {
+public:
+	virtual ~CollisionShape() = default;
+
+	virtual const geometry::AABB& getLocalAABB() = 0;
+
+	// whether getAnimatedLocalAABB() changes from frame to frame
+	virtual bool isAnimated() = 0;
+	virtual geometry::AABB getAnimatedLocalAABB() = 0;
+
+	// triangles in local space
+	virtual std::shared_ptr<const geometry::BVH> getCollisionBVH() = 0;
+};
+
+}
@@ -8,14 +8,21 @@ class Chunk;
 
 class Component {
 public:
+	// derived classes hide this to be updated in another phase
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Logic;
+
+	// classes derived from another component class hide this with that class,
+	// so that Entity::getComponents of it finds them as well
+	using BaseComponent = Component;
+
 	Component() :
-		entity_(nullptr),
 		isFirstUpdate_(true),
+		entity_(nullptr),
 		destroyed_(false) {}
 	virtual ~Component() = default;
 
-	void setEntity(std::shared_ptr<Entity> entity) {
-		entity_ = entity;
+	void setEntity(Entity& entity) {
+		entity_ = &entity;
 	}
 
 	Entity& getEntity() const {
@@ -23,13 +30,27 @@ public:
 		return *entity_;
 	}
 
-	void startAndUpdate() {
-		if (isFirstUpdate_) {
-			start();
-			isFirstUpdate_ = false;
+	bool hasEntity() const {
+		return entity_ != nullptr;
+	}
+
+	// the UpdateScheduler::UpdateFunction of T, which must be the dynamic type of component.
+	// the qualified calls skip the virtual dispatch of start() and update(),
+	// so derived classes override them as public members
+	template <class T>
+	static void startAndUpdate(Component& component) {
+		static_assert(IsUpdatable<T>::value, "start() and update() must be overridden as public members");
+		// physics::update only updates colliders and bodies, nothing would start them
+		static_assert(T::UPDATE_PHASE != UpdatePhase::Physics || !OverridesStart<T>::value,
+			"components updated in UpdatePhase::Physics must not override start()");
+
+		auto& derived = static_cast<T&>(component);
+		if (derived.isFirstUpdate_) {
+			derived.T::start();
+			derived.isFirstUpdate_ = false;
 		}
 
-		update();
+		derived.T::update();
 	}
 
 	void destroy() {
@@ -51,12 +72,26 @@ protected:
 	bool isFirstUpdate_;
 
 private:
-	std::shared_ptr<Entity> entity_;
+	// whether startAndUpdate<T> can make its qualified calls, checked from here
+	// so that start() and update() inherited from this class count as accessible
+	template <class T, class = void>
+	struct IsUpdatable : std::false_type {};
+	template <class T>
+	struct IsUpdatable<T, decltype(std::declval<T&>().T::start(), std::declval<T&>().T::update())> : std::true_type {};
+
+	template <class T>
+	using OverridesStart = std::integral_constant<bool, !std::is_same<decltype(&T::start), void (Component::*)()>::value>;
+
+	// not owning since the entity owns its components,
+	// the entity marks them destroyed when it goes away
+	Entity* entity_;
 	bool destroyed_;
 };
 
 class Drawable : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Presentation;
+
 	Drawable() = default;
 	virtual ~Drawable() = default;
 
@@ -74,6 +109,13 @@ public:
 protected:
 	virtual void update() {}
 	virtual void draw() = 0;
+
+	// to be called whenever isOpaque() may have changed, so that the chunk draws it in the right pass
+	void notifyOpaquenessChanged() {
+		if (hasEntity()) {
+			getEntity().invalidateDrawable(*this);
+		}
+	}
 };
 
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Collision.h"
+
+namespace islands {
+namespace physics {
+
+// overlapping collider pairs carried over between physics steps
+class ContactCache {
+public:
+	struct Contact {
+		// the cache does not keep destroyed colliders alive, so these expire
+		// for the exit contacts of colliders which were destroyed meanwhile
+		std::weak_ptr<Collider> a, b;
+		Collider::Serial serialA, serialB;
+		Collider::ContactEvent event;
+
+		// triangles of a MeshCollider found by the overlap test in the current step
+		geometry::MeshHits meshHits;
+
+		// movement applied to the body of a (b) to resolve the overlap
+		glm::vec3 correctorA, correctorB;
+
+		std::uint64_t step;
+	};
+
+	ContactCache();
+	virtual ~ContactCache() = default;
+
+	void beginStep();
+
+	// records that a and b overlap in the current step. a of the returned contact is
+	// the one with the smaller Collider::getSerial(), so a's callbacks run first
+	Contact& add(const std::shared_ptr<Collider>& a, const std::shared_ptr<Collider>& b);
+
+	// moves the contacts not added in the current step to the exits, ordered by serials
+	void endStep();
+
+	const std::vector<Contact*>& getContacts() const;
+	const std::vector<Contact>& getExits() const;
+
+	void clear();
+
+private:
+	using Key = std::pair<Collider::Serial, Collider::Serial>;
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const;
+	};
+
+	std::unordered_map<Key, Contact, KeyHash> contacts_;
+	std::vector<Contact*> current_;
+	std::vector<Contact> exits_;
+	std::uint64_t step_;
+};
+
+}
+}
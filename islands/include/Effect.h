@@ -9,6 +9,8 @@ namespace effect {
 
 class Damage : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Effect;
+
 	Damage(double duration = 0.3);
 	virtual ~Damage() = default;
 
@@ -23,6 +25,8 @@ private:
 
 class Scatter : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Effect;
+
 	using FinishCallback = std::function<void(void)>;
 
 	Scatter(const FinishCallback& callback);
@@ -39,6 +43,8 @@ private:
 
 class Sea : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Effect;
+
 	Sea() = default;
 	virtual ~Sea() = default;
 
@@ -51,6 +57,8 @@ private:
 
 class SwimRing : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Effect;
+
 	SwimRing() = default;
 	virtual ~SwimRing() = default;
 
@@ -64,6 +72,8 @@ private:
 
 class Fish : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Effect;
+
 	Fish() = default;
 	virtual ~Fish() = default;
 
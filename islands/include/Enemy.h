@@ -48,6 +48,20 @@ class BossDead : public StateMachine<T>::State {
 	}
 };
 
+// the player an enemy chases, looked up by name once in start() and then resolved
+// by handle, since the states of the enemies ask for it every tick
+class PlayerHandle {
+public:
+	void find(const Chunk& chunk);
+
+	// looks the player up by name again if the entity was replaced
+	std::shared_ptr<Entity> get();
+
+private:
+	const Chunk* chunk_ = nullptr;
+	EntityHandle handle_;
+};
+
 class Slime : public Component {
 public:
 	Slime() = default;
@@ -58,6 +72,7 @@ public:
 
 private:
 	StateMachine<Slime> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<Slime>::State;
 
@@ -91,6 +106,7 @@ public:
 
 private:
 	StateMachine<BigSlime> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<BigSlime>::State;
 
@@ -120,6 +136,7 @@ public:
 
 private:
 	StateMachine<Rabbit> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<Rabbit>::State;
 
@@ -167,6 +184,7 @@ public:
 
 private:
 	StateMachine<Crab> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<Crab>::State;
 
@@ -271,8 +289,10 @@ private:
 	std::shared_ptr<PhysicalBody> body_;
 	std::shared_ptr<ModelDrawer> drawer_;
 	std::shared_ptr<Health> health_;
+	PlayerHandle player_;
 	glm::vec3 direction_;
 
+	std::shared_ptr<Entity> getPlayer();
 	void lookAtPlayer();
 	void loopHoveringAnimation();
 
@@ -288,6 +308,7 @@ public:
 
 private:
 	StateMachine<Starfish> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<Starfish>::State;
 
@@ -339,6 +360,7 @@ private:
 	Color color_;
 
 	StateMachine<Eel> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<Eel>::State;
 
@@ -395,6 +417,7 @@ public:
 
 private:
 	StateMachine<Octopus> machine_;
+	PlayerHandle player_;
 
 	using State = StateMachine<Octopus>::State;
 
@@ -1,12 +1,85 @@
 #pragma once
 
 #include "Resource.h"
+#include "TransformStore.h"
+#include "SlotMap.h"
+#include "MemoryPool.h"
+#include "UpdateScheduler.h"
 
 namespace islands {
 
 class Component;
+class Drawable;
 class Chunk;
 
+namespace detail {
+
+using ComponentTypeId = std::uint32_t;
+
+// ids are dense, so that entities index their slots by them
+constexpr ComponentTypeId MAX_COMPONENT_TYPES = 64;
+
+ComponentTypeId generateComponentTypeId();
+
+// one id per type queried on entities, assigned on first use
+template <class T>
+ComponentTypeId getComponentTypeId() {
+	static const auto id = generateComponentTypeId();
+	return id;
+}
+
+}
+
+// components of type T of an entity without copying them out,
+// invalidated when components are added to or removed from the entity
+template <class T>
+class ComponentRange {
+public:
+	class Iterator {
+	public:
+		Iterator(const std::shared_ptr<Component>* ptr) : ptr_(ptr) {}
+
+		std::shared_ptr<T> operator*() const {
+			return std::static_pointer_cast<T>(*ptr_);
+		}
+		Iterator& operator++() {
+			++ptr_;
+			return *this;
+		}
+		bool operator!=(const Iterator& other) const {
+			return ptr_ != other.ptr_;
+		}
+
+	private:
+		const std::shared_ptr<Component>* ptr_;
+	};
+
+	ComponentRange(const std::vector<std::shared_ptr<Component>>& components) :
+		begin_(components.data()),
+		end_(components.data() + components.size()) {}
+
+	Iterator begin() const {
+		return begin_;
+	}
+	Iterator end() const {
+		return end_;
+	}
+	size_t size() const {
+		return end_ - begin_;
+	}
+	bool empty() const {
+		return begin_ == end_;
+	}
+
+private:
+	const std::shared_ptr<Component>* begin_;
+	const std::shared_ptr<Component>* end_;
+};
+
+// refers to an entity of a chunk, resolved by Chunk::getEntity,
+// and goes stale once the entity is destroyed
+using EntityHandle = SlotHandle;
+
 class Entity : public std::enable_shared_from_this<Entity> {
 public:
 	using MaskType = std::uint32_t;
@@ -22,24 +95,43 @@ public:
 		DynamicObject = Player | PlayerAttack | Enemy | EnemyAttack
 	};
 
-	Entity(const std::string& name, Chunk& chunk);
-	virtual ~Entity() = default;
+	Entity(const Name& name, Chunk& chunk, EntityHandle handle);
+	virtual ~Entity();
 
-	const std::string& getName() const;
+	const Name& getName() const;
+	EntityHandle getHandle() const;
 
+	// the transform lives in the TransformStore of the chunk,
+	// so these return copies that stay valid when other entities are created
 	void setPosition(const glm::vec3& position);
-	const glm::vec3& getPosition() const;
+	glm::vec3 getPosition() const;
 	void setQuaternion(const glm::quat& quaternion);
-	const glm::quat& getQuaternion() const;
+	glm::quat getQuaternion() const;
 	void setScale(const glm::vec3& scale);
-	const glm::vec3& getScale() const;
+	glm::vec3 getScale() const;
 
-	const glm::mat4& getModelMatrix() const;
+	glm::mat4 getModelMatrix() const;
 	glm::mat4 calculateMVPMatrix() const;
 
-	void update();
-	void drawOpaque() const;
-	void drawTransparent() const;
+	// transform blended between the last two ticks, used for drawing
+	void interpolate(float alpha);
+
+	// draws the current transform until the next tick instead of blending from the previous one,
+	// to be called after teleporting
+	void snapTransform();
+	const glm::vec3& getRenderPosition() const;
+	const glm::mat4& getRenderMatrix() const;
+
+	// incremented whenever position, quaternion or scale changes
+	using TransformVersion = TransformStore::Version;
+	TransformVersion getTransformVersion() const;
+
+	// around the updates of the components by the UpdateScheduler of the chunk
+	void beginUpdate();
+	void endUpdate();
+
+	// see Drawable::notifyOpaquenessChanged()
+	void invalidateDrawable(const Drawable& drawable);
 
 	Chunk& getChunk() const;
 
@@ -56,7 +148,7 @@ public:
 	getFirstComponent() const;
 
 	template <class T>
-	std::enable_if_t<std::is_base_of<Component, T>::value, std::vector<std::shared_ptr<T>>>
+	std::enable_if_t<std::is_base_of<Component, T>::value, ComponentRange<T>>
 	getComponents() const;
 
 	void setSelfMask(MaskType mask);
@@ -68,60 +160,104 @@ public:
 	bool isDestroyed();
 
 private:
-	const std::string name_;
+	const Name name_;
 	Chunk& chunk_;
-	glm::vec3 position_, scale_;
-	glm::quat quaternion_;
-	glm::mat4 modelMatrix_;
-	std::list<std::shared_ptr<Component>> components_;
+	const EntityHandle handle_;
+	const TransformStore::Index transform_;
+	glm::vec3 prevPosition_, prevScale_, renderPosition_;
+	glm::quat prevQuaternion_;
+	glm::mat4 renderMatrix_;
+	bool hasPrevTransform_;
 	MaskType selfMask_, filterMask_;
 	bool destroyed_;
 
-	void updateModelMatrix();
+	// components of each type and of each of its Component::BaseComponent chain down to
+	// Component itself, whose slot holds every component of the entity.
+	// slotIndices_[id] locates the slot of a type id in slots_, and bit id of
+	// componentTypes_ tells whether that slot has any components
+	using SlotIndex = std::uint8_t;
+	static constexpr SlotIndex NO_SLOT = std::numeric_limits<SlotIndex>::max();
+	static_assert(detail::MAX_COMPONENT_TYPES <= NO_SLOT, "slot index too narrow");
+	std::bitset<detail::MAX_COMPONENT_TYPES> componentTypes_;
+	std::array<SlotIndex, detail::MAX_COMPONENT_TYPES> slotIndices_;
+	std::vector<std::vector<std::shared_ptr<Component>>> slots_;
+
 	void cleanComponents();
+	std::shared_ptr<MemoryPools> getMemoryPools() const;
+	void registerComponent(std::shared_ptr<Component> component, detail::ComponentTypeId typeId,
+		UpdateScheduler::UpdateFunction updateFunction, UpdatePhase phase);
+	void addDrawable(std::shared_ptr<Drawable> drawable);
+
+	template <class T>
+	void registerDrawable(const std::shared_ptr<T>& component, std::true_type) {
+		addDrawable(component);
+	}
+	template <class T>
+	void registerDrawable(const std::shared_ptr<T>&, std::false_type) {}
+
+	void addToSlot(detail::ComponentTypeId typeId, std::shared_ptr<Component> component);
+	const std::vector<std::shared_ptr<Component>>& getSlot(detail::ComponentTypeId typeId) const;
+
+	template <class T>
+	std::enable_if_t<!std::is_same<T, Component>::value> addToSlots(std::shared_ptr<Component> component);
+	template <class T>
+	std::enable_if_t<std::is_same<T, Component>::value> addToSlots(std::shared_ptr<Component> component);
+
+	template <class T>
+	const std::vector<std::shared_ptr<Component>>& getSlot() const;
 };
 
 template<class T, class ...Args>
 inline std::enable_if_t<std::is_base_of<Component, T>::value, std::shared_ptr<T>>
 Entity::createComponent(Args&& ...args) {
-	const auto component = std::make_shared<T>(args...);
-	component->setEntity(shared_from_this());
-	components_.emplace_back(component);
+	const auto component = std::allocate_shared<T>(PoolAllocator<T>(getMemoryPools()), args...);
+	component->setEntity(*this);
+	addToSlots<T>(component);
+	registerComponent(component, detail::getComponentTypeId<T>(), &T::template startAndUpdate<T>, T::UPDATE_PHASE);
+	registerDrawable(component, std::is_base_of<Drawable, T>());
 	return component;
 }
 
 template<class T>
 inline std::enable_if_t<std::is_base_of<Component, T>::value, bool>
 Entity::hasComponent() const {
-	for (const auto c : components_) {
-		if (const auto t = std::dynamic_pointer_cast<T>(c)) {
-			return true;
-		}
-	}
-	return false;
+	return componentTypes_.test(detail::getComponentTypeId<T>());
 }
 
 template<class T>
 inline std::enable_if_t<std::is_base_of<Component, T>::value, std::shared_ptr<T>>
 Entity::getFirstComponent() const {
-	for (const auto c : components_) {
-		if (const auto t = std::dynamic_pointer_cast<T>(c)) {
-			return t;
-		}
+	const auto& slot = getSlot<T>();
+	if (slot.empty()) {
+		throw std::invalid_argument("not found");
 	}
-	throw std::invalid_argument("not found");
+	return std::static_pointer_cast<T>(slot.front());
 }
 
 template<class T>
-inline std::enable_if_t<std::is_base_of<Component, T>::value, std::vector<std::shared_ptr<T>>>
+inline std::enable_if_t<std::is_base_of<Component, T>::value, ComponentRange<T>>
 Entity::getComponents() const {
-	std::vector<std::shared_ptr<T>> comps;
-	for (const auto c : components_) {
-		if (const auto t = std::dynamic_pointer_cast<T>(c)) {
-			comps.emplace_back(t);
-		}
-	}
-	return comps;
+	return getSlot<T>();
+}
+
+template<class T>
+inline std::enable_if_t<!std::is_same<T, Component>::value>
+Entity::addToSlots(std::shared_ptr<Component> component) {
+	static_assert(std::is_base_of<typename T::BaseComponent, T>::value &&
+		!std::is_same<typename T::BaseComponent, T>::value, "BaseComponent must be a base class");
+	addToSlot(detail::getComponentTypeId<T>(), component);
+	addToSlots<typename T::BaseComponent>(component);
+}
+
+template<class T>
+inline std::enable_if_t<std::is_same<T, Component>::value>
+Entity::addToSlots(std::shared_ptr<Component> component) {
+	addToSlot(detail::getComponentTypeId<Component>(), component);
+}
+
+template<class T>
+inline const std::vector<std::shared_ptr<Component>>& Entity::getSlot() const {
+	return getSlot(detail::getComponentTypeId<T>());
 }
 
 }
@@ -30,7 +30,7 @@ namespace islands {
 class GameScene : public Scene {
 public:
 	GameScene(const std::string& levelFilename);
-	virtual ~GameScene() = default;
+	virtual ~GameScene();
 
 	void update();
 	void draw();
@@ -48,6 +48,9 @@ private:
 	std::shared_ptr<Sound> currentBGM_;
 	std::shared_ptr<Sound::Instance> currentBGMInstance_;
 
+	float tickAccumulator_;
+
+	void tick();
 	void jumpTo(const glm::ivec3& destination);
 };
 
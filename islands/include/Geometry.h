@@ -32,21 +32,86 @@ struct Plane {
 struct Capsule {
 	float r;
 	glm::vec3 a, b;
+
+	glm::vec3 getClosestPointOnAxis(const glm::vec3& point) const;
+};
+
+// segment from origin to origin + length * direction
+struct Ray {
+	glm::vec3 origin;
+	glm::vec3 direction; // normalized
+	float length;
+
+	glm::vec3 getPoint(float distance) const;
+};
+
+// up to 4 triangles in structure-of-arrays layout with data precomputed for sphere tests
+struct alignas(16) TriangleBatch {
+	static const size_t SIZE = 4;
+
+	// [axis][lane]
+	float v0[3][SIZE], v1[3][SIZE], v2[3][SIZE];
+	float normal[3][SIZE]; // normalized
+	float planeD[SIZE]; // dot(normal, v0)
+	float edges[3][3][SIZE]; // [v1 - v0, v2 - v1, v0 - v2][axis][lane]
+	float edgeLengthSq[3][SIZE];
+	std::uint32_t count;
+
+	TriangleBatch();
+	void set(size_t lane, const Triangle& triangle);
+	glm::vec3 getNormal(size_t lane) const;
 };
 
+class BVH;
+
 struct CollisionMesh {
-	std::vector<Triangle> triangles, collisionTriangles;
+	std::shared_ptr<const BVH> bvh; // local space
+	glm::mat4 modelMatrix, inverseModelMatrix;
+	float uniformScale; // 0 if scaling is not uniform
+};
+
+// triangles of a CollisionMesh found by an intersection test, in global space
+struct MeshHits {
+	std::vector<Triangle> triangles;
+	std::vector<glm::vec3> normals; // normalized
+
+	void clear();
+	bool empty() const;
+	glm::vec3 getAverageNormal() const;
 };
 
 bool intersect(const AABB& a, const AABB& b);
 bool intersect(const Triangle& triangle, const Sphere& sphere);
 bool intersect(const Sphere& a, const Sphere& b);
 bool intersect(const Sphere& sphere, const Plane& plane);
-bool intersect(CollisionMesh& mesh, const Sphere& sphere);
+bool intersect(const CollisionMesh& mesh, const Sphere& sphere, MeshHits& hits);
+bool intersect(const Capsule& capsule, const Sphere& sphere);
+bool intersect(const Capsule& a, const Capsule& b);
+bool intersect(const Capsule& capsule, const Plane& plane);
+bool intersect(const Triangle& triangle, const Capsule& capsule);
+bool intersect(const CollisionMesh& mesh, const Capsule& capsule, MeshHits& hits);
+bool intersect(const AABB& aabb, const Sphere& sphere);
+
+// distance is set to the first hit along the ray, 0 if the ray starts inside
+bool intersect(const Ray& ray, const AABB& aabb, float& distance);
+bool intersect(const Ray& ray, const Sphere& sphere, float& distance);
+bool intersect(const Ray& ray, const Plane& plane, float& distance);
+bool intersect(const Ray& ray, const Capsule& capsule, float& distance);
+bool intersect(const Ray& ray, const Triangle& triangle, float& distance);
+bool intersect(const Ray& ray, const CollisionMesh& mesh, float& distance);
+
+// bit i is set if the i-th triangle of the batch intersects the sphere
+unsigned int intersect(const TriangleBatch& batch, const Sphere& sphere);
+unsigned int intersectScalar(const TriangleBatch& batch, const Sphere& sphere);
 
 float getSinkage(const Triangle& triangle, const Sphere& sphere);
+float getSinkage(const Triangle& triangle, const glm::vec3& normal, const Sphere& sphere);
 float getSinkage(const Sphere& a, const Sphere& b);
 float getSinkage(const Sphere& sphere, const Plane& plane);
+float getSinkage(const Capsule& capsule, const Sphere& sphere);
+float getSinkage(const Capsule& a, const Capsule& b);
+float getSinkage(const Capsule& capsule, const Plane& plane);
+float getSinkage(const Triangle& triangle, const glm::vec3& normal, const Capsule& capsule);
 
 glm::quat directionToQuaternion(const glm::vec3& dir, const glm::vec3& front);
 
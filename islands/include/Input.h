@@ -9,6 +9,15 @@ public:
 		Attack
 	};
 
+	using CommandMask = std::uint8_t;
+
+	// everything the game reads from the devices in a frame
+	struct State {
+		glm::vec2 direction;
+		CommandMask commands; // bit i is set if Command(i) is active
+		bool anyButtonPressed, anyButtonExceptArrowPressed;
+	};
+
 	using KeyboardCallback = std::function<void(int, int)>;
 
 	class Device {
@@ -72,6 +81,11 @@ public:
 	static Input& getInstance();
 
 	void update();
+
+	// called at the start of each game tick, hands the commands pressed since the previous tick
+	// to isCommandActive() so that presses in frames without a tick are not lost
+	void beginTick();
+
 	void registerKeyboardCallback(const KeyboardCallback& callback);
 	const glm::vec2 getDirection() const;
 	bool isCommandActive(Command command) const;
@@ -85,10 +99,15 @@ private:
 	std::vector<KeyboardCallback> keyboardCallbacks_;
 	Keyboard keyboard_;
 	Gamepad gamepad_;
-	glm::vec2 direction_;
+	State state_;
+	CommandMask pendingCommands_, tickCommands_;
 	std::unordered_set<int> pressedKeys_;
 
 	Input();
+
+	bool isCommandActiveOnDevices(Command command) const;
+	bool anyButtonPressedOnDevices() const;
+	bool anyButtonExceptArrowPressedOnDevices() const;
 };
 
 }
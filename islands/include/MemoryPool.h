@@ -0,0 +1,83 @@
+#pragma once
+
+namespace islands {
+
+// fixed-size blocks carved out of pages, freed blocks are reused before new pages are allocated
+class MemoryPool {
+public:
+	explicit MemoryPool(size_t blockSize);
+	MemoryPool(const MemoryPool&) = delete;
+	MemoryPool& operator=(const MemoryPool&) = delete;
+	virtual ~MemoryPool() = default;
+
+	void* allocate();
+	void deallocate(void* block);
+
+private:
+	static constexpr size_t BLOCKS_PER_PAGE = 64;
+
+	const size_t blockSize_;
+	std::vector<std::unique_ptr<char[]>> pages_;
+	size_t numUsedInLastPage_;
+	void* freeList_;
+};
+
+// one MemoryPool per size class, larger requests go to the global allocator
+class MemoryPools {
+public:
+	MemoryPools() = default;
+	MemoryPools(const MemoryPools&) = delete;
+	MemoryPools& operator=(const MemoryPools&) = delete;
+	virtual ~MemoryPools() = default;
+
+	void* allocate(size_t size);
+	void deallocate(void* p, size_t size);
+
+private:
+	static constexpr size_t GRANULARITY = 16;
+	static constexpr size_t MAX_BLOCK_SIZE = 1024;
+
+	std::vector<std::unique_ptr<MemoryPool>> pools_;
+
+	static size_t getPoolIndex(size_t size);
+};
+
+// for std::allocate_shared, every copy keeps the pools alive
+// so that the memory is released once the last object allocated from them is gone
+template <class T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	PoolAllocator(std::shared_ptr<MemoryPools> pools) : pools_(std::move(pools)) {}
+
+	template <class U>
+	PoolAllocator(const PoolAllocator<U>& other) : pools_(other.pools_) {}
+
+	T* allocate(size_t n) {
+		static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned type");
+		return static_cast<T*>(pools_->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t n) {
+		pools_->deallocate(p, n * sizeof(T));
+	}
+
+	template <class U>
+	bool operator==(const PoolAllocator<U>& other) const {
+		return pools_ == other.pools_;
+	}
+
+	template <class U>
+	bool operator!=(const PoolAllocator<U>& other) const {
+		return pools_ != other.pools_;
+	}
+
+private:
+	template <class U>
+	friend class PoolAllocator;
+
+	std::shared_ptr<MemoryPools> pools_;
+};
+
+}
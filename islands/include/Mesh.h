@@ -37,6 +37,7 @@ public:
 	const std::vector<glm::vec3>& getVertices() const;
 	const std::vector<GLuint>& getIndices() const;
 	std::vector<geometry::Triangle> getTriangles() const;
+	const geometry::AABB& getLocalAABB() const;
 
 protected:
 	void uploadImpl() override;
@@ -53,6 +54,7 @@ private:
 	std::vector<glm::vec3> vertices_, normals_;
 	std::vector<glm::vec2> uvs_;
 	std::vector<GLuint> indices_;
+	geometry::AABB localAABB_;
 	const bool hasUV_;
 	MeshMaterial meshMaterial_;
 };
@@ -71,6 +73,9 @@ public:
 	void applyBoneTransform(std::shared_ptr<Program> program) const;
 	std::vector<glm::vec3> getTransformAppliedVertices() const;
 
+	// bounds of getTransformAppliedVertices() derived from the bone transforms
+	geometry::AABB getTransformAppliedAABB() const;
+
 private:
 	struct Bone {
 		glm::mat4 offset;
@@ -119,6 +124,10 @@ private:
 	glm::mat4 globalInverse_;
 	std::vector<std::shared_ptr<Bone>> bones_;
 
+	// bind pose bounds of the vertices each bone influences
+	std::vector<geometry::AABB> boneAABBs_;
+	bool hasPartiallyWeightedVertices_;
+
 	GLuint boneBuffer_;
 	std::vector<BoneDataPerVertex> boneData_;
 
@@ -5,10 +5,11 @@
 #include "Texture.h"
 #include "Mesh.h"
 #include "Geometry.h"
+#include "CollisionShape.h"
 
 namespace islands {
 
-class Model : public SharedResource<Model> {
+class Model : public SharedResource<Model>, public CollisionShape {
 public:
 	Model(const std::string& filename);
 
@@ -21,18 +22,30 @@ public:
 	const std::vector<std::shared_ptr<Mesh>>& getMeshes();
 	bool isOpaque();
 	bool hasSkinnedMesh();
-	const geometry::AABB& getLocalAABB();
+	const geometry::AABB& getLocalAABB() override;
+
+	// skinned meshes in their current pose
+	bool isAnimated() override;
+	geometry::AABB getAnimatedLocalAABB() override;
+
+	// prefers asset/collision/<name>.bvh written by the collision cooker,
+	// in which case the model itself is not loaded
+	std::shared_ptr<const geometry::BVH> getCollisionBVH() override;
 
 private:
 	std::vector<std::shared_ptr<Mesh>> meshes_;
 	bool opaque_, hasSkinned_;
 	geometry::AABB localAABB_;
+	std::shared_ptr<const geometry::BVH> collisionBVH_;
+	bool collisionCooked_;
 
 	void loadImpl() override;
 };
 
 class ModelDrawer : public Drawable {
 public:
+	using BaseComponent = Drawable;
+
 	ModelDrawer(std::shared_ptr<Model> model);
 	virtual ~ModelDrawer() = default;
 
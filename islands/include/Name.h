@@ -0,0 +1,50 @@
+#pragma once
+
+namespace islands {
+
+// string interned into a global table, compared and hashed by its 32-bit symbol.
+// generated names are formatted only when their string is requested,
+// and never equal an interned name even if the strings match
+class Name {
+public:
+	Name();
+	Name(const char* str);
+	Name(const std::string& str);
+
+	// "<serial>_<prefix>"
+	static Name generate(const Name& prefix, std::uint32_t serial);
+
+	const std::string& str() const;
+
+	bool operator==(const Name& other) const {
+		return symbol_ == other.symbol_ && serial_ == other.serial_;
+	}
+	bool operator!=(const Name& other) const {
+		return !(*this == other);
+	}
+
+	size_t hash() const {
+		return std::hash<std::uint64_t>()(static_cast<std::uint64_t>(serial_) << 32 | symbol_);
+	}
+
+private:
+	std::uint32_t symbol_;
+
+	// 0 for interned names, serial + 1 for generated ones
+	std::uint32_t serial_;
+};
+
+std::ostream& operator<<(std::ostream& os, const Name& name);
+
+}
+
+namespace std {
+
+template <>
+struct hash<islands::Name> {
+	size_t operator()(const islands::Name& name) const {
+		return name.hash();
+	}
+};
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Name.h"
+
 namespace islands {
 
 class NameGenerator {
@@ -8,15 +10,14 @@ public:
 	NameGenerator& operator=(const NameGenerator&) = delete;
 	virtual ~NameGenerator() = default;
 
-	static std::string generate(const std::string& postfix = "n") {
+	// "<n>_<postfix>", formatted only when the string of the name is requested
+	static Name generate(const Name& postfix = "n") {
 		static NameGenerator instance;
-		std::stringstream ss;
-		ss << instance.n_++ << "_" << postfix;
-		return ss.str();
+		return Name::generate(postfix, instance.n_++);
 	}
 
 private:
-	unsigned long int n_;
+	std::uint32_t n_;
 
 	NameGenerator() : n_(0) {}
 };
@@ -7,6 +7,8 @@ namespace islands {
 
 class PhysicalBody : public Component {
 public:
+	static constexpr UpdatePhase UPDATE_PHASE = UpdatePhase::Physics;
+
 	PhysicalBody(std::shared_ptr<Collider> collider);
 	virtual ~PhysicalBody() = default;
 
@@ -21,7 +23,8 @@ public:
 	void addVelocity(const glm::vec3& velocity);
 	const glm::vec3& getVelocity() const;
 	void moveBy(const glm::vec3& offset) const;
-	void stepForward() const;
+	// unlike setVelocity(), accelerating here keeps a resting body counting towards sleep
+	void stepForward(const glm::vec3& acceleration);
 	void applyImpulse(const glm::vec3& impulse);
 
 	void setReceiveGravity(bool receive);
@@ -29,11 +32,21 @@ public:
 	void setGhost(bool isGhost);
 	bool isGhost() const;
 
+	// sleeping bodies are skipped by physics until something wakes them up
+	bool isSleeping() const;
+	bool isMoving() const;
+	void wakeUp();
+	void sleepIfResting(const glm::vec3& displacement);
+	bool isMovedWhileSleeping() const;
+
 private:
 	std::shared_ptr<Collider> collider_;
 	float mass_;
 	glm::vec3 velocity_;
 	bool receiveGravity_, isGhost_;
+	bool sleeping_;
+	size_t restingSteps_;
+	Entity::TransformVersion sleepTransformVersion_;
 };
 
 }
@@ -6,7 +6,21 @@ namespace islands {
 
 namespace physics {
 
-void update(const Chunk& chunk);
+struct Statistics {
+	size_t numColliders;
+	size_t numCandidatePairs;
+	size_t numNarrowphaseTests;
+	size_t numContacts;
+	size_t numBodies;
+	size_t numSleepingBodies;
+};
+
+// the simulation advances in fixed steps of 1 / tick rate seconds
+void setTickRate(float ticksPerSecond);
+float getTickDeltaTime();
+
+void update(Chunk& chunk);
+const Statistics& getLastStatistics();
 
 }
 
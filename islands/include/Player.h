@@ -12,6 +12,7 @@ public:
 	Player();
 	virtual ~Player() = default;
 
+	void start() override;
 	void update() override;
 
 private:
@@ -27,8 +28,6 @@ private:
 	std::shared_ptr<ModelDrawer> drawer_;
 	std::shared_ptr<Health> health_;
 	double attackAnimStartedAt_;
-
-	void start() override;
 };
 
 }
@@ -49,6 +49,10 @@ public:
 		return samples_.at(name).elapsedTime;
 	}
 
+	bool hasSection(const std::string& name) const {
+		return samples_.find(name) != samples_.end();
+	}
+
 	void clearSamples() {
 		samples_.clear();
 	}
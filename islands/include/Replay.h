@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Input.h"
+
+namespace islands {
+
+// records what makes a session nondeterministic (input, frame deltas and random seeds)
+// or feeds a recording back in place of them, checking that the game state follows it
+class Replay {
+public:
+	enum class Mode {
+		None,
+		Record,
+		Play
+	};
+
+	Replay(const Replay&) = delete;
+	Replay& operator=(const Replay&) = delete;
+	virtual ~Replay();
+
+	static Replay& getInstance();
+
+	void startRecording(const std::string& filename);
+	void startPlayback(const std::string& filename);
+
+	// writes the recording out when recording
+	void stop();
+
+	Mode getMode() const;
+
+	// each frame starts with the delta time and then the input state
+	float processDeltaTime(float deltaTime);
+	void processInput(Input::State& state);
+
+	// commands are latched across frames and consumed by ticks, so they are recorded per tick
+	void processTickCommands(Input::CommandMask& commands);
+
+	// seed for random engines, drawn from std::random_device unless playing back
+	std::uint32_t generateSeed();
+
+	// called once per game tick with a hash of the game state, which is recorded
+	// or compared with the recording to report the first tick playback diverges at
+	void processStateHash(std::uint64_t hash);
+
+private:
+	struct Frame {
+		float deltaTime;
+		Input::State input;
+	};
+
+	Mode mode_;
+	std::string filename_;
+	std::vector<Frame> frames_;
+	std::vector<Input::CommandMask> tickCommands_;
+	std::vector<std::uint32_t> seeds_;
+	std::vector<std::uint64_t> stateHashes_;
+	size_t frameIndex_, tickCommandIndex_, seedIndex_, tickIndex_;
+	bool diverged_;
+
+	Replay();
+
+	void finishPlayback();
+};
+
+}
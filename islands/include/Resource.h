@@ -1,11 +1,13 @@
 #pragma once
 
+#include "Name.h"
+
 namespace islands {
 
 class Resource {
 public:
 	Resource();
-	Resource(const std::string& name);
+	Resource(const Name& name);
 
 	virtual ~Resource() = default;
 
@@ -26,7 +28,7 @@ private:
 		Uploaded
 	};
 
-	const std::string name_;
+	const Name name_;
 	State status_;
 };
 
@@ -50,7 +52,7 @@ public:
 	static std::shared_ptr<T> get(const std::string& name) {
 		const auto iter = getInstances().find(name);
 		if (iter == getInstances().end()) {
-			throw std::exception("not found");
+			throw std::invalid_argument("not found");
 		} else {
 			return iter->second;
 		}
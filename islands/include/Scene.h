@@ -2,6 +2,7 @@
 
 #include "Sprite.h"
 #include "Shader.h"
+#include "Window.h"
 
 namespace islands {
 
@@ -67,7 +68,7 @@ SceneManager::changeScene(bool fade, Args&&... args) {
 		fadeInOut();
 	} else {
 		transition_.status = TransitionState::None;
-		transition_.startedAt = glfwGetTime();
+		transition_.startedAt = Window::getInstance().getTime();
 	}
 }
 
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace islands {
+
+// time of the simulation, advanced by GameScene::tick() by one tick at a time.
+// anything updated in ticks reads this rather than Window::getTime(),
+// which moves once per frame however many ticks the frame runs
+class SimulationClock {
+public:
+	SimulationClock(const SimulationClock&) = delete;
+	SimulationClock& operator=(const SimulationClock&) = delete;
+	virtual ~SimulationClock() = default;
+
+	static SimulationClock& getInstance() {
+		static SimulationClock instance;
+		return instance;
+	}
+
+	void advance(double deltaTime) {
+		time_ += deltaTime;
+	}
+
+	double getTime() const {
+		return time_;
+	}
+
+private:
+	double time_;
+
+	SimulationClock() : time_(0.0) {}
+};
+
+}
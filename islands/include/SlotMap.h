@@ -0,0 +1,129 @@
+#pragma once
+
+namespace islands {
+
+// refers to an element of a SlotMap and goes stale once the element is erased
+struct SlotHandle {
+	std::uint32_t index = 0;
+
+	// never 0 for a handle that was given out by a SlotMap
+	std::uint32_t generation = 0;
+};
+
+// elements stored contiguously in insertion order and addressed by generational handles.
+// erase() is O(1) and leaves the element in place until compact() removes all erased ones at once
+template <class T>
+class SlotMap {
+public:
+	SlotMap() = default;
+	virtual ~SlotMap() = default;
+
+	// create receives the handle of the new element and returns the element
+	template <class Create>
+	const T& insert(Create create);
+
+	// nullptr if the handle is stale
+	const T* find(SlotHandle handle) const;
+
+	void erase(SlotHandle handle);
+	void compact();
+
+	// includes erased elements until the next compact()
+	const std::vector<T>& getValues() const;
+	size_t size() const;
+
+private:
+	struct Slot {
+		std::uint32_t valueIndex;
+		std::uint32_t generation;
+	};
+
+	std::vector<T> values_;
+	std::vector<SlotHandle> valueHandles_;
+	std::vector<Slot> slots_;
+	std::vector<std::uint32_t> freeSlots_, erasedSlots_;
+};
+
+template <class T>
+template <class Create>
+inline const T& SlotMap<T>::insert(Create create) {
+	SlotHandle handle;
+	if (freeSlots_.empty()) {
+		handle.index = static_cast<std::uint32_t>(slots_.size());
+		slots_.push_back({0, 1});
+	} else {
+		handle.index = freeSlots_.back();
+		freeSlots_.pop_back();
+	}
+	auto& slot = slots_[handle.index];
+	handle.generation = slot.generation;
+
+	values_.emplace_back(create(handle));
+	valueHandles_.emplace_back(handle);
+	slot.valueIndex = static_cast<std::uint32_t>(values_.size() - 1);
+	return values_.back();
+}
+
+template <class T>
+inline const T* SlotMap<T>::find(SlotHandle handle) const {
+	if (handle.index >= slots_.size()) {
+		return nullptr;
+	}
+	const auto& slot = slots_[handle.index];
+	if (slot.generation != handle.generation) {
+		return nullptr;
+	}
+	return &values_[slot.valueIndex];
+}
+
+template <class T>
+inline void SlotMap<T>::erase(SlotHandle handle) {
+	if (!find(handle)) {
+		return;
+	}
+	auto& slot = slots_[handle.index];
+	if (++slot.generation == 0) {
+		slot.generation = 1;
+	}
+
+	// the slot is reused only after compact() has removed its element
+	erasedSlots_.emplace_back(handle.index);
+}
+
+template <class T>
+inline void SlotMap<T>::compact() {
+	if (erasedSlots_.empty()) {
+		return;
+	}
+
+	std::uint32_t dest = 0;
+	for (std::uint32_t i = 0; i < values_.size(); ++i) {
+		const auto handle = valueHandles_[i];
+		auto& slot = slots_[handle.index];
+		if (slot.generation != handle.generation) {
+			continue;
+		}
+		if (dest != i) {
+			values_[dest] = std::move(values_[i]);
+			valueHandles_[dest] = handle;
+		}
+		slot.valueIndex = dest++;
+	}
+	values_.erase(values_.begin() + dest, values_.end());
+	valueHandles_.erase(valueHandles_.begin() + dest, valueHandles_.end());
+
+	freeSlots_.insert(freeSlots_.end(), erasedSlots_.begin(), erasedSlots_.end());
+	erasedSlots_.clear();
+}
+
+template <class T>
+inline const std::vector<T>& SlotMap<T>::getValues() const {
+	return values_;
+}
+
+template <class T>
+inline size_t SlotMap<T>::size() const {
+	return values_.size();
+}
+
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "SimulationClock.h"
+
 namespace islands {
 
-template <typename T>
+// the current state lives in a buffer inside the machine, so transitions do not allocate.
+// a transition requested while a state is updated takes effect once the update returns
+template <typename T, size_t StateCapacity = 128>
 class StateMachine {
 public:
 	class State {
@@ -10,7 +14,7 @@ public:
 		State(StateMachine& machine) :
 			machine_(machine),
 			isFirstUpdate_(true),
-			startedAt_(glfwGetTime()) {}
+			startedAt_(SimulationClock::getInstance().getTime()) {}
 
 		void startAndUpdate(T& parent) {
 			if (isFirstUpdate_) {
@@ -25,13 +29,13 @@ public:
 		virtual void update(T&) {}
 
 		double getElapsed() const {
-			return glfwGetTime() - startedAt_;
+			return SimulationClock::getInstance().getTime() - startedAt_;
 		}
 
 		template<class StateType, class... Args>
 		std::enable_if_t<std::is_base_of<State, StateType>::value, void>
 		changeState(Args&&... args) const {
-			machine_.changeState<StateType, Args...>(std::forward(args)...);
+			machine_.template changeState<StateType>(std::forward<Args>(args)...);
 		}
 
 	private:
@@ -40,25 +44,72 @@ public:
 		double startedAt_;
 	};
 
-	StateMachine() = default;
+	StateMachine() :
+		current_(0),
+		hasNext_(false) {}
+
+	StateMachine(const StateMachine&) = delete;
+	StateMachine& operator=(const StateMachine&) = delete;
 	virtual ~StateMachine() = default;
 
 	void update(T& parent) {
-		if (current_) {
-			current_->startAndUpdate(parent);
-		} else {
-			throw std::exception("not initialized with state");
+		applyTransition();
+		if (!slots_[current_].state) {
+			throw std::logic_error("not initialized with state");
 		}
+		slots_[current_].state->startAndUpdate(parent);
+		applyTransition();
 	}
 
 	template<class StateType, class... Args>
 	std::enable_if_t<std::is_base_of<State, StateType>::value, void>
 	changeState(Args&&... args) {
-		current_ = std::make_shared<StateType>(*this, std::forward(args)...);
+		static_assert(sizeof(StateType) <= StateCapacity, "state does not fit, raise StateCapacity");
+		static_assert(alignof(StateType) <= alignof(std::max_align_t), "over-aligned state");
+
+		// the other slot, since the current state may be running
+		auto& slot = slots_[1 - current_];
+		slot.reset();
+		slot.state = new (&slot.storage) StateType(*this, std::forward<Args>(args)...);
+		slot.destroy = [](State* state) {
+			static_cast<StateType*>(state)->~StateType();
+		};
+		hasNext_ = true;
 	}
 
 private:
-	std::shared_ptr<State> current_;
+	struct Slot {
+		std::aligned_storage_t<StateCapacity, alignof(std::max_align_t)> storage;
+		State* state = nullptr;
+		void (*destroy)(State*) = nullptr;
+
+		Slot() = default;
+		Slot(const Slot&) = delete;
+		Slot& operator=(const Slot&) = delete;
+
+		~Slot() {
+			reset();
+		}
+
+		void reset() {
+			if (state) {
+				destroy(state);
+				state = nullptr;
+			}
+		}
+	};
+
+	std::array<Slot, 2> slots_;
+	size_t current_;
+	bool hasNext_;
+
+	void applyTransition() {
+		if (hasNext_) {
+			slots_[current_].reset();
+			current_ = 1 - current_;
+			hasNext_ = false;
+		}
+	}
 };
 
 }
@@ -39,5 +39,25 @@ struct MemoryStatus {
 
 MemoryStatus getPhysicalMemoryStatus();
 
+// read-only view of a whole file mapped into memory
+class MappedFile {
+public:
+	MappedFile(const std::string& filename);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	virtual ~MappedFile();
+
+	bool isOpen() const;
+	const char* getData() const;
+	size_t getSize() const;
+
+private:
+	const char* data_;
+	size_t size_;
+#ifdef _WIN32
+	HANDLE file_, mapping_;
+#endif
+};
+
 }
 }
@@ -0,0 +1,48 @@
+#pragma once
+
+namespace islands {
+
+// positions, rotations, scales and model matrices of the entities of a chunk, stored as parallel arrays.
+// setters only mark entries dirty and updateMatrices() rebuilds the dirty model matrices in one pass
+class TransformStore {
+public:
+	using Index = std::uint32_t;
+	using Version = std::uint32_t;
+
+	TransformStore() = default;
+	TransformStore(const TransformStore&) = delete;
+	TransformStore& operator=(const TransformStore&) = delete;
+	virtual ~TransformStore() = default;
+
+	// identity transform, reusing the entries of destroyed ones
+	Index create();
+	void destroy(Index index);
+
+	void setPosition(Index index, const glm::vec3& position);
+	const glm::vec3& getPosition(Index index) const;
+	void setQuaternion(Index index, const glm::quat& quaternion);
+	const glm::quat& getQuaternion(Index index) const;
+	void setScale(Index index, const glm::vec3& scale);
+	const glm::vec3& getScale(Index index) const;
+
+	// rebuilds the matrix first if it is dirty
+	const glm::mat4& getModelMatrix(Index index);
+
+	// incremented whenever position, quaternion or scale changes
+	Version getVersion(Index index) const;
+
+	void updateMatrices();
+
+private:
+	std::vector<glm::vec3> positions_, scales_;
+	std::vector<glm::quat> quaternions_;
+	std::vector<glm::mat4> modelMatrices_;
+	std::vector<Version> versions_;
+	std::vector<std::uint8_t> dirty_;
+	std::vector<Index> dirtyIndices_, freeIndices_;
+
+	void markDirty(Index index);
+	void updateMatrix(Index index);
+};
+
+}
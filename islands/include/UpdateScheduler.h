@@ -0,0 +1,63 @@
+#pragma once
+
+namespace islands {
+
+class Component;
+
+// components are updated phase by phase, and within a phase type by type,
+// in the order the types were first registered
+enum class UpdatePhase {
+	Logic,        // players, enemies and other behaviors
+	Effect,       // effects layered on top of them
+	Presentation, // animation of drawables
+
+	// bodies and colliders, which physics::update steps after the phases above
+	// instead of the scheduler updating them
+	Physics
+};
+
+class UpdateScheduler {
+public:
+	// phases the scheduler updates, Physics is not one of them
+	static constexpr size_t NUM_PHASES = static_cast<size_t>(UpdatePhase::Presentation) + 1;
+
+	// updates a component whose dynamic type is known to the caller, see Component::startAndUpdate
+	using UpdateFunction = void (*)(Component&);
+
+	UpdateScheduler() = default;
+	UpdateScheduler(const UpdateScheduler&) = delete;
+	UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+	virtual ~UpdateScheduler() = default;
+
+	// all components of a type id must be added with the same update function and phase
+	void add(std::shared_ptr<Component> component, std::uint32_t typeId,
+		UpdateFunction updateFunction, UpdatePhase phase);
+
+	// a component added during the update is started and updated in this update
+	// if the group of its type has not finished yet, e.g. an effect created by a logic
+	// component. Otherwise, e.g. a logic component created by an effect or a component
+	// whose type group ran earlier in the same phase, it waits until the next update
+	void update();
+
+	// name of the profiler section each phase is timed in, in debug builds
+	static const char* getPhaseName(size_t phase);
+
+private:
+	struct Group {
+		std::uint32_t typeId;
+		UpdateFunction updateFunction;
+		std::vector<std::shared_ptr<Component>> components;
+	};
+
+	struct GroupLocation {
+		size_t phase, index;
+	};
+
+	std::array<std::vector<Group>, NUM_PHASES> phases_;
+	std::vector<GroupLocation> groupLocations_;
+
+	// drops destroyed components and the ones of destroyed entities
+	void clean();
+};
+
+}
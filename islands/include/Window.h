@@ -15,6 +15,10 @@ public:
 	glm::uvec2 getFramebufferSize() const;
 	void registerFramebufferResizeCallback(std::function<void(int, int)>);
 	float getDeltaTime() const;
+
+	// sum of the delta times, for what runs once per frame such as scene transitions.
+	// what runs in ticks uses SimulationClock
+	double getTime() const;
 	void saveScreenShot(const char* filename) const;
 
 private:
@@ -23,6 +27,7 @@ private:
 	std::vector<std::function<void(int, int)>> fbResizeCallbacks_;
 	double lastUpdateTime_;
 	float deltaTime_;
+	double time_;
 
 	Window();
 	
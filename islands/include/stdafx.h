@@ -11,6 +11,8 @@
 #include <iterator>
 #include <vector>
 #include <array>
+#include <bitset>
+#include <deque>
 #include <stack>
 #include <queue>
 #include <unordered_map>
@@ -18,7 +20,10 @@
 #include <list>
 #include <memory>
 #include <functional>
+#include <limits>
+#include <stdexcept>
 #include <random>
+#include <chrono>
 #include <future>
 
 #define NOMINMAX
@@ -27,24 +32,49 @@
 #include <glad/glad.h>
 #include <glfw3.h>
 
+#ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable: 4201)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmisleading-indentation"
+#endif
 #define GLM_FORCE_SWIZZLE
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
 #include <gtc/type_ptr.hpp>
 #include <gtc/quaternion.hpp>
 #include <gtx/io.hpp>
+#ifdef _MSC_VER
 #pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
 
+#ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable: 4819)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-copy"
+#endif
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#ifdef _MSC_VER
 #pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
 
+#ifndef _MSC_VER
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
 #include <picojson/picojson.h>
+#ifndef _MSC_VER
+#pragma GCC diagnostic pop
+#endif
 #include <portaudio/portaudio.h>
 #include <zip.h>
 
@@ -24,6 +24,10 @@ AssetArchive& AssetArchive::getInstance() {
 	return instance;
 }
 
+bool AssetArchive::exists(const std::string& filename) const {
+	return zip_name_locate(zip_, filename.c_str(), 0) >= 0;
+}
+
 std::vector<char> AssetArchive::readFile(const std::string& filename) const {
 	struct zip_stat stat = {};
 	const auto ret = zip_stat(zip_, filename.c_str(), 0, &stat);
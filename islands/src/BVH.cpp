@@ -0,0 +1,250 @@
+#include "BVH.h"
+
+namespace islands {
+namespace geometry {
+
+namespace {
+
+const char MAGIC[] = {'I', 'B', 'V', 'H'};
+constexpr std::uint32_t VERSION = 2;
+
+// sections of a blob start at multiples of this so that batches can be used in place
+constexpr size_t BLOB_ALIGNMENT = alignof(TriangleBatch);
+
+struct BlobHeader {
+	char magic[sizeof(MAGIC)];
+	std::uint32_t version;
+	std::uint32_t numNodes, numBatches;
+	std::uint32_t nodeSize, batchSize, triangleSize;
+	std::uint32_t nodeOffset, batchOffset, triangleOffset;
+	std::uint64_t sourceChecksum;
+};
+
+size_t alignUp(size_t offset) {
+	return (offset + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+}
+
+}
+
+BVH::BVH(std::vector<Triangle> triangles) :
+	nodes_(nullptr),
+	batches_(nullptr),
+	triangles_(nullptr),
+	numNodes_(0),
+	numBatches_(0),
+	sourceChecksum_(0) {
+
+	if (triangles.empty()) {
+		return;
+	}
+
+	nodeStorage_.reserve(2 * triangles.size() / MAX_LEAF_SIZE + 1);
+	batchStorage_.reserve(triangles.size() / MAX_LEAF_SIZE + 1);
+	triangleStorage_.reserve(batchStorage_.capacity() * TriangleBatch::SIZE);
+	nodeStorage_.emplace_back();
+	build(triangles, 0, 0, static_cast<std::uint32_t>(triangles.size()));
+	nodeStorage_.shrink_to_fit();
+	batchStorage_.shrink_to_fit();
+	triangleStorage_.shrink_to_fit();
+
+	nodes_ = nodeStorage_.data();
+	batches_ = batchStorage_.data();
+	triangles_ = triangleStorage_.data();
+	numNodes_ = static_cast<std::uint32_t>(nodeStorage_.size());
+	numBatches_ = static_cast<std::uint32_t>(batchStorage_.size());
+}
+
+BVH::BVH(std::shared_ptr<const char> blob, size_t size) :
+	blob_(blob) {
+
+	BlobHeader header;
+	if (size < sizeof(header)) {
+		throw std::invalid_argument("truncated BVH");
+	}
+	std::memcpy(&header, blob.get(), sizeof(header));
+	if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), header.magic) || header.version != VERSION ||
+		header.nodeSize != sizeof(Node) || header.batchSize != sizeof(TriangleBatch) ||
+		header.triangleSize != sizeof(Triangle)) {
+
+		throw std::invalid_argument("incompatible BVH");
+	}
+	// getBounds() and query() start from the root node
+	if (header.numNodes == 0) {
+		throw std::invalid_argument("empty BVH");
+	}
+	// the sections are used in place and must neither overlap the header nor be misaligned
+	if (header.nodeOffset < sizeof(header) || header.nodeOffset % BLOB_ALIGNMENT != 0 ||
+		header.batchOffset % BLOB_ALIGNMENT != 0 || header.triangleOffset % BLOB_ALIGNMENT != 0) {
+
+		throw std::invalid_argument("misaligned BVH");
+	}
+	const auto triangleEnd = header.triangleOffset + size_t(header.numBatches) * TriangleBatch::SIZE * sizeof(Triangle);
+	if (header.batchOffset < header.nodeOffset + size_t(header.numNodes) * sizeof(Node) ||
+		header.triangleOffset < header.batchOffset + size_t(header.numBatches) * sizeof(TriangleBatch) ||
+		triangleEnd > size) {
+
+		throw std::invalid_argument("truncated BVH");
+	}
+
+	numNodes_ = header.numNodes;
+	numBatches_ = header.numBatches;
+	sourceChecksum_ = header.sourceChecksum;
+	const auto data = blob.get();
+	if (reinterpret_cast<std::uintptr_t>(data) % BLOB_ALIGNMENT == 0) {
+		nodes_ = reinterpret_cast<const Node*>(data + header.nodeOffset);
+		batches_ = reinterpret_cast<const TriangleBatch*>(data + header.batchOffset);
+		triangles_ = reinterpret_cast<const Triangle*>(data + header.triangleOffset);
+	} else {
+		// e.g. read from the asset archive into an unaligned buffer
+		nodeStorage_.resize(numNodes_);
+		batchStorage_.resize(numBatches_);
+		triangleStorage_.resize(numBatches_ * TriangleBatch::SIZE);
+		std::memcpy(nodeStorage_.data(), data + header.nodeOffset, numNodes_ * sizeof(Node));
+		std::memcpy(batchStorage_.data(), data + header.batchOffset, numBatches_ * sizeof(TriangleBatch));
+		std::memcpy(triangleStorage_.data(), data + header.triangleOffset, triangleStorage_.size() * sizeof(Triangle));
+		nodes_ = nodeStorage_.data();
+		batches_ = batchStorage_.data();
+		triangles_ = triangleStorage_.data();
+		blob_.reset();
+	}
+	validate();
+}
+
+const AABB& BVH::getBounds() const {
+	assert(numNodes_ > 0);
+	return nodes_[0].aabb;
+}
+
+std::uint32_t BVH::getNumNodes() const {
+	return numNodes_;
+}
+
+std::uint64_t BVH::getSourceChecksum() const {
+	return sourceChecksum_;
+}
+
+void BVH::write(std::ostream& os, std::uint64_t sourceChecksum) const {
+	assert(numNodes_ > 0); // an empty BVH would not be read back
+	BlobHeader header = {};
+	std::copy(MAGIC, MAGIC + sizeof(MAGIC), header.magic);
+	header.version = VERSION;
+	header.numNodes = numNodes_;
+	header.numBatches = numBatches_;
+	header.nodeSize = sizeof(Node);
+	header.batchSize = sizeof(TriangleBatch);
+	header.triangleSize = sizeof(Triangle);
+	header.nodeOffset = static_cast<std::uint32_t>(alignUp(sizeof(header)));
+	header.batchOffset = static_cast<std::uint32_t>(alignUp(header.nodeOffset + numNodes_ * sizeof(Node)));
+	header.triangleOffset = static_cast<std::uint32_t>(alignUp(header.batchOffset + numBatches_ * sizeof(TriangleBatch)));
+	header.sourceChecksum = sourceChecksum;
+
+	size_t offset = 0;
+	const auto append = [&](const void* data, size_t size, size_t at) {
+		static const char PADDING[BLOB_ALIGNMENT] = {};
+		os.write(PADDING, at - offset);
+		os.write(static_cast<const char*>(data), size);
+		offset = at + size;
+	};
+	append(&header, sizeof(header), 0);
+	append(nodes_, numNodes_ * sizeof(Node), header.nodeOffset);
+	append(batches_, numBatches_ * sizeof(TriangleBatch), header.batchOffset);
+	append(triangles_, numBatches_ * TriangleBatch::SIZE * sizeof(Triangle), header.triangleOffset);
+}
+
+void BVH::build(std::vector<Triangle>& triangles, std::uint32_t nodeIndex, std::uint32_t begin, std::uint32_t end) {
+	AABB aabb{glm::vec3(INFINITY), glm::vec3(-INFINITY)};
+	AABB centerAABB = aabb;
+	for (auto i = begin; i < end; ++i) {
+		const auto& t = triangles[i];
+		aabb.min = glm::min(aabb.min, glm::min(t.v0, glm::min(t.v1, t.v2)));
+		aabb.max = glm::max(aabb.max, glm::max(t.v0, glm::max(t.v1, t.v2)));
+		centerAABB.min = glm::min(centerAABB.min, t.getCenter());
+		centerAABB.max = glm::max(centerAABB.max, t.getCenter());
+	}
+	nodeStorage_[nodeIndex].aabb = aabb;
+
+	if (end - begin <= MAX_LEAF_SIZE) {
+		nodeStorage_[nodeIndex].first = static_cast<std::uint32_t>(batchStorage_.size());
+		nodeStorage_[nodeIndex].count = end - begin;
+
+		batchStorage_.emplace_back();
+		for (auto i = begin; i < end; ++i) {
+			batchStorage_.back().set(i - begin, triangles[i]);
+			triangleStorage_.emplace_back(triangles[i]);
+		}
+		triangleStorage_.resize(batchStorage_.size() * TriangleBatch::SIZE);
+		return;
+	}
+
+	// median split along the longest axis of triangle centers
+	const auto extent = centerAABB.max - centerAABB.min;
+	glm::length_t axis = 0;
+	if (extent.y > extent[axis]) {
+		axis = 1;
+	}
+	if (extent.z > extent[axis]) {
+		axis = 2;
+	}
+	const auto mid = begin + (end - begin) / 2;
+	std::nth_element(triangles.begin() + begin, triangles.begin() + mid, triangles.begin() + end,
+		[axis](const Triangle& a, const Triangle& b) {
+		return a.getCenter()[axis] < b.getCenter()[axis];
+	});
+
+	const auto left = static_cast<std::uint32_t>(nodeStorage_.size());
+	nodeStorage_.emplace_back();
+	build(triangles, left, begin, mid);
+
+	const auto right = static_cast<std::uint32_t>(nodeStorage_.size());
+	nodeStorage_.emplace_back();
+	build(triangles, right, mid, end);
+
+	assert(left == nodeIndex + 1);
+	nodeStorage_[nodeIndex].first = right;
+	nodeStorage_[nodeIndex].count = 0;
+}
+
+void BVH::validate() const {
+	// the intersection kernels loop over batch.count lanes of the 4-wide arrays
+	for (std::uint32_t i = 0; i < numBatches_; ++i) {
+		if (batches_[i].count > TriangleBatch::SIZE) {
+			throw std::invalid_argument("corrupted BVH");
+		}
+	}
+
+	// children come after their parent, so depths are final when a node is reached
+	std::vector<std::uint8_t> depths(numNodes_, 0);
+	for (std::uint32_t i = 0; i < numNodes_; ++i) {
+		const auto& node = nodes_[i];
+		if (node.count > 0) {
+			if (node.count > MAX_LEAF_SIZE || node.first >= numBatches_ ||
+				batches_[node.first].count != node.count) {
+
+				throw std::invalid_argument("corrupted BVH");
+			}
+			continue;
+		}
+
+		// query() pushes the children on top of one pending node per level above
+		const size_t depth = depths[i] + 1;
+		if (i + 1 >= numNodes_ || node.first <= i + 1 || node.first >= numNodes_ ||
+			depth + 1 >= MAX_QUERY_STACK_SIZE) {
+
+			throw std::invalid_argument("corrupted BVH");
+		}
+		depths[i + 1] = std::max(depths[i + 1], static_cast<std::uint8_t>(depth));
+		depths[node.first] = std::max(depths[node.first], static_cast<std::uint8_t>(depth));
+	}
+}
+
+std::uint64_t calculateChecksum(const void* data, size_t size) {
+	std::uint64_t hash = 0xcbf29ce484222325;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<const unsigned char*>(data)[i];
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+}
+}
@@ -0,0 +1,94 @@
+#include "Broadphase.h"
+#include "Entity.h"
+
+namespace islands {
+namespace physics {
+
+namespace {
+
+bool overlapsYZ(const geometry::AABB& a, const geometry::AABB& b) {
+	return a.max.y >= b.min.y && a.min.y <= b.max.y &&
+		a.max.z >= b.min.z && a.min.z <= b.max.z;
+}
+
+bool isFinite(const geometry::AABB& aabb) {
+	for (int i = 0; i < 3; ++i) {
+		if (!std::isfinite(aabb.min[i]) || !std::isfinite(aabb.max[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool canCollide(const Entity& a, const Entity& b) {
+	return (a.getFilterMask() & b.getSelfMask()) || (b.getFilterMask() & a.getSelfMask());
+}
+
+}
+
+Broadphase::Broadphase() :
+	bounds_{glm::vec3(INFINITY), glm::vec3(-INFINITY)},
+	maxScannedWidth_(0.f) {}
+
+std::vector<std::shared_ptr<Collider>>& Broadphase::getColliders() {
+	return colliders_;
+}
+
+void Broadphase::update() {
+	aabbs_.clear();
+	endpoints_.clear();
+	wide_.clear();
+	bounds_ = {glm::vec3(INFINITY), glm::vec3(-INFINITY)};
+	maxScannedWidth_ = 0.f;
+	for (size_t i = 0; i < colliders_.size(); ++i) {
+		aabbs_.emplace_back(colliders_[i]->getBroadphaseAABB());
+		const auto& aabb = aabbs_.back();
+		const bool bounded = isFinite(aabb);
+		if (bounded) {
+			bounds_.min = glm::min(bounds_.min, aabb.min);
+			bounds_.max = glm::max(bounds_.max, aabb.max);
+		}
+
+		const auto width = aabb.max.x - aabb.min.x;
+		const bool wide = !bounded || width > MAX_SCANNED_WIDTH;
+		const auto type = colliders_[i]->getType();
+		endpoints_.push_back({aabb.min.x, aabb.max.x, i, wide,
+			Collider::getTypeBit(type), Collider::getPairableTypes(type)});
+		if (wide) {
+			wide_.emplace_back(i);
+		} else {
+			maxScannedWidth_ = std::max(maxScannedWidth_, width);
+		}
+	}
+	std::sort(endpoints_.begin(), endpoints_.end(), [](const Endpoint& a, const Endpoint& b) {
+		return a.min < b.min;
+	});
+
+	pairs_.clear();
+	for (auto iter = endpoints_.begin(); iter != endpoints_.end(); ++iter) {
+		const auto& a = *colliders_[iter->index];
+		for (auto j = iter + 1; j != endpoints_.end() && j->min <= iter->max; ++j) {
+			if (!(iter->pairableTypes & j->type)) {
+				continue;
+			}
+			const auto& b = *colliders_[j->index];
+			if (&a.getEntity() == &b.getEntity() || !canCollide(a.getEntity(), b.getEntity())) {
+				continue;
+			}
+			if (overlapsYZ(aabbs_[iter->index], aabbs_[j->index])) {
+				pairs_.emplace_back(iter->index, j->index);
+			}
+		}
+	}
+}
+
+const std::vector<Broadphase::Pair>& Broadphase::getPairs() const {
+	return pairs_;
+}
+
+const geometry::AABB& Broadphase::getBounds() const {
+	return bounds_;
+}
+
+}
+}
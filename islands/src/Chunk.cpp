@@ -1,262 +1,320 @@
 #include "Chunk.h"
-#include "System.h"
 #include "Camera.h"
-#include "PhysicalBody.h"
 #include "Physics.h"
-#include "Player.h"
-#include "Enemy.h"
-#include "SpecialObjects.h"
-#include "AssetArchive.h"
-
-glm::vec3 toVec3(const picojson::value& v) {
-	const auto& obj = v.get<picojson::object>();
-	return{
-		obj.at("x").get<double>(),
-		obj.at("y").get<double>(),
-		obj.at("z").get<double>()
-	};
-}
-
-glm::quat toQuat(const picojson::value& v) {
-	const auto& obj = v.get<picojson::object>();
-	return{
-		static_cast<float>(obj.at("w").get<double>()),
-		static_cast<float>(obj.at("x").get<double>()),
-		static_cast<float>(obj.at("y").get<double>()),
-		static_cast<float>(obj.at("z").get<double>())
-	};
-}
+#include "Profiler.h"
 
 namespace islands {
 
 Chunk::Chunk(const std::string& filename) :
 	Resource(filename),
-	cameraOffset_(15.f) {}
+	memoryPools_(std::make_shared<MemoryPools>()),
+	cameraOffset_(15.f) {
+
+	rebuildGlobalAABB();
+}
 
-std::shared_ptr<Entity> Chunk::createEntity(const std::string& name) {
-	const auto entity = std::make_shared<Entity>(name, *this);
-	entities_.emplace_back(entity);
+std::shared_ptr<Entity> Chunk::createEntity(const Name& name) {
+	const auto& entity = entities_.insert([&](EntityHandle handle) {
+		return std::allocate_shared<Entity>(PoolAllocator<Entity>(memoryPools_), name, *this, handle);
+	});
+	entitiesByName_.emplace(name, entity.get());
 	return entity;
 }
 
-const std::list<std::shared_ptr<Entity>>& Chunk::getEntities() const {
-	return entities_;
+const std::vector<std::shared_ptr<Entity>>& Chunk::getEntities() const {
+	return entities_.getValues();
 }
 
-std::shared_ptr<Entity> Chunk::getEntityByName(const std::string& name) const {
-	const auto iter = std::find_if(entities_.begin(), entities_.end(),
-		[&name](std::shared_ptr<Entity> e) {
-		return e->getName() == name;
-	});
-	if (iter != entities_.end()) {
-		return *iter;
+std::shared_ptr<Entity> Chunk::getEntityByName(const Name& name) const {
+	const auto iter = entitiesByName_.find(name);
+	if (iter != entitiesByName_.end()) {
+		return iter->second->shared_from_this();
 	} else {
 		throw std::invalid_argument("not found");
 	}
 }
 
+std::shared_ptr<Entity> Chunk::getEntity(EntityHandle handle) const {
+	const auto entity = entities_.find(handle);
+	if (!entity || (*entity)->isDestroyed()) {
+		return nullptr;
+	}
+	return *entity;
+}
+
 void Chunk::update() {
-	load();
-	
 	cleanEntities();
-	for (const auto e : entities_) {
-		e->update();
+	for (const auto& entity : entities_.getValues()) {
+		entity->beginUpdate();
 	}
-	cleanEntities();
+	updateScheduler_.update();
 
-	aabb_.min = glm::vec3(INFINITY);
-	aabb_.max = glm::vec3(-INFINITY);
-	for (const auto entity : entities_) {
-		if ((entity->getSelfMask() & Entity::Mask::StaticObject) &&
-			entity->hasComponent<MeshCollider>()) {
-			for (const auto collider : entity->getComponents<Collider>()) {
-				aabb_.min = glm::min(aabb_.min, collider->getGlobalAABB().min);
-				aabb_.max = glm::max(aabb_.max, collider->getGlobalAABB().max);
-			}
-		}
+	// also the entities created during the updates
+	for (const auto& entity : entities_.getValues()) {
+		entity->endUpdate();
 	}
-	aabb_.min.z = -INFINITY; // FIXME
-	aabb_.max.z = INFINITY;
+	cleanEntities();
 
+#ifdef _DEBUG
+	Profiler::getInstance().enterSection("physics");
+#endif
 	physics::update(*this);
+#ifdef _DEBUG
+	Profiler::getInstance().leaveSection("physics");
+#endif
 }
 
-void Chunk::draw() {
-	upload();
+void Chunk::interpolate(float alpha) {
+	transforms_.updateMatrices();
+	for (const auto& entity : entities_.getValues()) {
+		entity->interpolate(alpha);
+	}
+}
 
+void Chunk::draw() {
 	Camera::getInstance().setOffset(cameraOffset_);
 
-	for (const auto entity : entities_) {
-		entity->drawOpaque();
-	}
-	for (const auto entity : entities_) {
-		entity->drawTransparent();
-	}
+	sortDrawables();
+	drawAndCleanDrawables(opaqueDrawables_);
+	drawAndCleanDrawables(transparentDrawables_);
 }
 
 const geometry::AABB& Chunk::getGlobalAABB() const {
 	return aabb_;
 }
 
-std::shared_ptr<Sound> Chunk::getBGM() const {
-	return bgm_;
+void Chunk::updateStaticBounds(const Collider& collider, const geometry::AABB& aabb) {
+	const auto result = staticBounds_.emplace(&collider, aabb);
+	const auto grows = result.second || aabb.contains(result.first->second);
+	result.first->second = aabb;
+	if (grows) {
+		aabb_.min = glm::min(aabb_.min, aabb.min);
+		aabb_.max = glm::max(aabb_.max, aabb.max);
+		aabb_.min.z = -INFINITY; // FIXME
+		aabb_.max.z = INFINITY;
+	} else {
+		rebuildGlobalAABB();
+	}
 }
 
-void Chunk::loadImpl() {
-	picojson::value json;
-	{
-#ifdef ENABLE_ASSET_ARCHIVE
-		const auto filePath = LEVEL_DIR + '/' + getName();
-		picojson::parse(json, AssetArchive::getInstance().readTextFile(filePath));
-#else
-		const auto filePath = LEVEL_DIR + sys::getFilePathSeparator() + getName();
-		std::ifstream ifs(filePath);
-		ifs >> json;
-#endif
+void Chunk::removeStaticBounds(const Collider& collider) {
+	if (staticBounds_.erase(&collider) > 0) {
+		rebuildGlobalAABB();
 	}
+}
 
-	createEntity("Player")->createComponent<Player>();
+physics::ContactCache& Chunk::getContactCache() {
+	return contactCache_;
+}
 
-	if (json.contains("camera")) {
-		const auto& cameraProp = json.get("camera").get<picojson::object>();
-		if (cameraProp.find("offset") != cameraProp.end()) {
-			cameraOffset_ = static_cast<float>(cameraProp.at("offset").get<double>());
+physics::Broadphase& Chunk::getBroadphase() {
+	return broadphase_;
+}
+
+TransformStore& Chunk::getTransforms() {
+	return transforms_;
+}
+
+UpdateScheduler& Chunk::getUpdateScheduler() {
+	return updateScheduler_;
+}
+
+void Chunk::addDrawable(std::shared_ptr<Drawable> drawable) {
+	unsortedDrawables_.emplace_back(drawable);
+}
+
+void Chunk::invalidateDrawable(const Drawable& drawable) {
+	for (auto drawables : {&opaqueDrawables_, &transparentDrawables_}) {
+		const auto iter = std::find_if(drawables->begin(), drawables->end(),
+			[&drawable](const std::shared_ptr<Drawable>& d) {
+			return d.get() == &drawable;
+		});
+		if (iter != drawables->end()) {
+			unsortedDrawables_.emplace_back(*iter);
+			drawables->erase(iter);
+			return;
 		}
 	}
+}
 
-	bgm_ = Sound::createOrGet(json.get("bgm").get<std::string>());
+std::shared_ptr<MemoryPools> Chunk::getMemoryPools() const {
+	return memoryPools_;
+}
 
-	for (const auto& ent : json.get("entities").get<picojson::object>()) {
-		const auto entity = createEntity(ent.first);
-		const auto& prop = ent.second.get<picojson::object>();
-		if (prop.find("position") != prop.end()) {
-			entity->setPosition(toVec3(prop.at("position")));
+namespace {
+
+bool matchesMask(const Collider& collider, Entity::MaskType mask) {
+	if (collider.isDestroyed()) {
+		return false;
+	}
+	auto& entity = collider.getEntity();
+	return (entity.getSelfMask() & mask) && !entity.isDestroyed();
+}
+
+}
+
+bool Chunk::raycast(const geometry::Ray& ray, Entity::MaskType mask, RaycastHit& hit) const {
+	const auto end = ray.getPoint(ray.length);
+	const geometry::AABB aabb{glm::min(ray.origin, end), glm::max(ray.origin, end)};
+
+	hit.collider = nullptr;
+	hit.distance = INFINITY;
+	broadphase_.query(aabb, [&](const std::shared_ptr<Collider>& collider) {
+		if (!matchesMask(*collider, mask)) {
+			return;
 		}
-		if (prop.find("quaternion") != prop.end()) {
-			entity->setQuaternion(toQuat(prop.at("quaternion")));
+		float distance;
+		if (!geometry::intersect(ray, collider->getBroadphaseAABB(), distance) || distance >= hit.distance) {
+			return;
 		}
-		if (prop.find("scale") != prop.end()) {
-			entity->setScale(toVec3(prop.at("scale")));
+		if (collider->raycast(ray, distance) && distance < hit.distance) {
+			hit.collider = collider;
+			hit.distance = distance;
 		}
-		entity->setFilterMask(Entity::Mask::DynamicObject);
-		entity->setSelfMask(Entity::Mask::StageObject);
+	});
+	return hit.collider != nullptr;
+}
 
-		std::shared_ptr<Model> model(nullptr);
-		if (prop.find("model") != prop.end()) {
-			const auto& modelProp = prop.at("model").get<picojson::object>();
+std::vector<std::shared_ptr<Collider>> Chunk::overlapSphere(const geometry::Sphere& sphere, Entity::MaskType mask) const {
+	const auto rv = glm::vec3(sphere.radius);
+	std::vector<std::shared_ptr<Collider>> result;
+	broadphase_.query({sphere.center - rv, sphere.center + rv}, [&](const std::shared_ptr<Collider>& collider) {
+		if (matchesMask(*collider, mask) && collider->overlapsSphere(sphere)) {
+			result.emplace_back(collider);
+		}
+	});
+	return result;
+}
 
-			model = Model::createOrGet(modelProp.at("mesh").get<std::string>());
-			const auto drawer = entity->createComponent<ModelDrawer>(model);
+std::vector<std::shared_ptr<Entity>> Chunk::findNearestEntities(const glm::vec3& point, size_t count, Entity::MaskType mask) const {
+	std::unordered_map<Entity*, float> distances;
 
-			if (modelProp.find("visible") != modelProp.end()) {
-				drawer->setVisible(modelProp.at("visible").get<bool>());
+	// grow the search box until it holds enough entities within its inscribed sphere
+	for (auto radius = 8.f; ; radius *= 2.f) {
+		const auto rv = glm::vec3(radius);
+		const geometry::AABB box{point - rv, point + rv};
+		distances.clear();
+		broadphase_.query(box, [&](const std::shared_ptr<Collider>& collider) {
+			if (!matchesMask(*collider, mask)) {
+				return;
 			}
-			if (modelProp.find("lightmap") != modelProp.end()) {
-				const auto material = std::make_shared<Material>();
-				material->setTexture(Texture2D::createOrGet(
-					modelProp.at("lightmap").get<std::string>()));
-				drawer->pushMaterial(material);
+			const auto aabb = collider->getBroadphaseAABB();
+			const auto d = glm::distance(point, glm::clamp(point, aabb.min, aabb.max));
+			const auto result = distances.emplace(&collider->getEntity(), d);
+			if (!result.second) {
+				result.first->second = std::min(result.first->second, d);
 			}
-			if (modelProp.find("cull_face") != modelProp.end()) {
-				drawer->setCullFaceEnabled(modelProp.at("cull_face").get<bool>());
+		});
+
+		const auto isExhaustive = box.contains(broadphase_.getBounds());
+		size_t numWithin = 0;
+		for (const auto& pair : distances) {
+			if (pair.second <= radius) {
+				++numWithin;
 			}
 		}
+		if (numWithin >= count || isExhaustive) {
+			break;
+		}
+	}
 
-		if (prop.find("collision") != prop.end()) {
-			if (prop.at("collision").is<std::string>()) {
-				const auto& type = prop.at("collision").get<std::string>();
-				if (type == "sphere") {
-					assert(model);
-					entity->createComponent<SphereCollider>(model);
-				} else {
-					throw std::exception("not implemented");
-				}
-			} else {
-				const auto& collisionProp = prop.at("collision").get<picojson::object>();
-				const auto& type = collisionProp.at("type").get<std::string>();
-				const auto& meshName = collisionProp.at("mesh_name").get<std::string>();
-				const auto collisionMesh = Model::createOrGet(meshName);
-				if (type == "mesh") {
-					entity->createComponent<MeshCollider>(collisionMesh);
-				}  else if (type == "wall") {
-					entity->createComponent<MeshCollider>(collisionMesh);
-					entity->setSelfMask(Entity::Mask::CollisionWall);
-				} else if (type == "floor") {
-					entity->createComponent<FloorCollider>(collisionMesh);
-				} else {
-					throw std::exception("not implemented");
-				}
-			}
+	std::vector<std::pair<float, std::shared_ptr<Entity>>> found;
+	for (const auto& pair : distances) {
+		found.emplace_back(pair.second, pair.first->shared_from_this());
+	}
+	const auto n = std::min(count, found.size());
+	std::partial_sort(found.begin(), found.begin() + n, found.end(),
+		[](const std::pair<float, std::shared_ptr<Entity>>& a, const std::pair<float, std::shared_ptr<Entity>>& b) {
+		return a.first < b.first;
+	});
+
+	std::vector<std::shared_ptr<Entity>> result;
+	for (size_t i = 0; i < n; ++i) {
+		result.emplace_back(found[i].second);
+	}
+	return result;
+}
+
+void Chunk::setCameraOffset(float offset) {
+	cameraOffset_ = offset;
+}
+
+void Chunk::setBGM(std::shared_ptr<Sound> bgm) {
+	bgm_ = bgm;
+}
+
+std::shared_ptr<Sound> Chunk::getBGM() const {
+	return bgm_;
+}
+
+void Chunk::cleanEntities() {
+	for (const auto& e : entities_.getValues()) {
+		if (!e->isDestroyed()) {
+			continue;
+		}
+		// whatever the mask is now, it may have been static when the bounds were added
+		for (const auto collider : e->getComponents<MeshCollider>()) {
+			removeStaticBounds(*collider);
 		}
 
-		if (prop.find("enemy") != prop.end()) {
-			const auto& enemyProp = prop.at("enemy").get<picojson::object>();
-			
-			const auto& type = enemyProp.at("type").get<std::string>();
-			if (type == "slime") {
-				entity->createComponent<enemy::Slime>();
-			} else if (type == "big_slime") {
-				entity->createComponent<enemy::BigSlime>();
-			} else if (type == "rabbit") {
-				entity->createComponent<enemy::Rabbit>();
-			} else if (type == "crab") {
-				entity->createComponent<enemy::Crab>();
-			} else if (type == "dragon") {
-				entity->createComponent<enemy::Dragon>();
-			} else if (type == "starfish") {
-				entity->createComponent<enemy::Starfish>();
-			} else if (type == "eel") {
-				const auto& colorStr = enemyProp.at("color").get<std::string>();
-				enemy::Eel::Color color;
-				if (colorStr == "orange") {
-					color = enemy::Eel::Color::Orange;
-				} else if (colorStr == "white") {
-					color = enemy::Eel::Color::White;
-				} else {
-					throw std::exception("not implemented");
-				}
-				entity->createComponent<enemy::Eel>(color);
-			} else if (type == "octopus") {
-				entity->createComponent<enemy::Octopus>();
-			} else {
-				throw std::exception("not implemented");
+		const auto range = entitiesByName_.equal_range(e->getName());
+		for (auto iter = range.first; iter != range.second; ++iter) {
+			if (iter->second == e.get()) {
+				entitiesByName_.erase(iter);
+				break;
 			}
 		}
+		entities_.erase(e->getHandle());
+	}
+	entities_.compact();
+}
 
-		if (prop.find("special") != prop.end()) {
-			const auto& specialProp = prop.at("special").get<picojson::object>();
-			
-			const auto& type = specialProp.at("type").get<std::string>();
-			if (type == "curer") {
-				const auto radius = static_cast<float>(specialProp.at("radius").get<double>());
-				entity->createComponent<specialobj::Curer>(radius);
-			} else {
-				throw std::exception("not implemented");
-			}
+void Chunk::sortDrawables() {
+	for (const auto& drawable : unsortedDrawables_) {
+		(drawable->isOpaque() ? opaqueDrawables_ : transparentDrawables_).emplace_back(drawable);
+	}
+	unsortedDrawables_.clear();
+
+	// transparent drawables are blended back to front. stable so that drawables at the same
+	// depth, e.g. those of one entity, keep the order they were added in
+	const auto& view = Camera::getInstance().getViewMatrix();
+	const auto getDepth = [&view](const Drawable& drawable) {
+		if (drawable.isDestroyed() || !drawable.hasEntity()) {
+			return 0.f;
 		}
+		return (view * glm::vec4(drawable.getEntity().getRenderPosition(), 1.f)).z;
+	};
+	std::stable_sort(transparentDrawables_.begin(), transparentDrawables_.end(),
+		[&getDepth](const std::shared_ptr<Drawable>& a, const std::shared_ptr<Drawable>& b) {
+		return getDepth(*a) < getDepth(*b);
+	});
+}
 
-		if (prop.find("effect") != prop.end()) {
-			const auto& effects = prop.at("effect").get<picojson::array>();
-			for (const auto& e : effects) {
-				const auto& type = e.get<std::string>();
-				if (type == "sea") {
-					entity->createComponent<effect::Sea>();
-				} else if (type == "swim_ring") {
-					entity->createComponent<effect::SwimRing>();
-				} else if (type == "fish") {
-					entity->createComponent<effect::Fish>();
-				} else {
-					throw std::exception("not implemented");
-				}
-			}
+void Chunk::drawAndCleanDrawables(std::vector<std::shared_ptr<Drawable>>& drawables) {
+	size_t numAlive = 0;
+	for (size_t i = 0; i < drawables.size(); ++i) {
+		auto& drawable = drawables[i];
+		if (drawable->isDestroyed() || drawable->getEntity().isDestroyed()) {
+			continue;
+		}
+		drawable->startAndDraw();
+		if (numAlive != i) {
+			drawables[numAlive] = std::move(drawable);
 		}
+		++numAlive;
 	}
+	drawables.erase(drawables.begin() + numAlive, drawables.end());
 }
 
-void Chunk::cleanEntities() {
-	entities_.erase(std::remove_if(entities_.begin(), entities_.end(), [](std::shared_ptr<Entity> e) {
-		return e->isDestroyed();
-	}), entities_.end());
+void Chunk::rebuildGlobalAABB() {
+	aabb_.min = glm::vec3(INFINITY);
+	aabb_.max = glm::vec3(-INFINITY);
+	for (const auto& pair : staticBounds_) {
+		aabb_.min = glm::min(aabb_.min, pair.second.min);
+		aabb_.max = glm::max(aabb_.max, pair.second.max);
+	}
+	aabb_.min.z = -INFINITY; // FIXME
+	aabb_.max.z = INFINITY;
 }
 
 }
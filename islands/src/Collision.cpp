@@ -4,79 +4,303 @@
 
 namespace islands {
 
-Collider::Collider(std::shared_ptr<Model> model) :
-	model_(model),
+namespace {
+
+using Type = Collider::Type;
+constexpr size_t NUM_TYPES = static_cast<size_t>(Type::NumTypes);
+
+template <Type> struct ColliderClass;
+template <> struct ColliderClass<Type::AABB> { using type = AABBCollider; };
+template <> struct ColliderClass<Type::Sphere> { using type = SphereCollider; };
+template <> struct ColliderClass<Type::Plane> { using type = PlaneCollider; };
+template <> struct ColliderClass<Type::Mesh> { using type = MeshCollider; };
+template <> struct ColliderClass<Type::Capsule> { using type = CapsuleCollider; };
+
+template <size_t I>
+using ColliderOf = typename ColliderClass<static_cast<Type>(I)>::type;
+
+// narrowphase kernels, each specialized for one order of a pair only
+
+template <class A, class B>
+struct Intersection : std::false_type {};
+
+template <>
+struct Intersection<AABBCollider, AABBCollider> : std::true_type {
+	static bool compute(const AABBCollider& a, const AABBCollider& b, geometry::MeshHits&) {
+		return geometry::intersect(a.getGlobalAABB(), b.getGlobalAABB());
+	}
+};
+
+template <>
+struct Intersection<SphereCollider, SphereCollider> : std::true_type {
+	static bool compute(const SphereCollider& a, const SphereCollider& b, geometry::MeshHits&) {
+		return geometry::intersect(a.getGlobalSphere(), b.getGlobalSphere());
+	}
+};
+
+template <>
+struct Intersection<SphereCollider, PlaneCollider> : std::true_type {
+	static bool compute(const SphereCollider& a, const PlaneCollider& b, geometry::MeshHits&) {
+		return geometry::intersect(a.getGlobalSphere(), b.getGlobalPlane());
+	}
+};
+
+template <>
+struct Intersection<SphereCollider, MeshCollider> : std::true_type {
+	static bool compute(const SphereCollider& a, const MeshCollider& b, geometry::MeshHits& hits) {
+		return geometry::intersect(b.getCollisionMesh(), a.getGlobalSphere(), hits);
+	}
+};
+
+template <>
+struct Intersection<CapsuleCollider, SphereCollider> : std::true_type {
+	static bool compute(const CapsuleCollider& a, const SphereCollider& b, geometry::MeshHits&) {
+		return geometry::intersect(a.getGlobalCapsule(), b.getGlobalSphere());
+	}
+};
+
+template <>
+struct Intersection<CapsuleCollider, CapsuleCollider> : std::true_type {
+	static bool compute(const CapsuleCollider& a, const CapsuleCollider& b, geometry::MeshHits&) {
+		return geometry::intersect(a.getGlobalCapsule(), b.getGlobalCapsule());
+	}
+};
+
+template <>
+struct Intersection<CapsuleCollider, PlaneCollider> : std::true_type {
+	static bool compute(const CapsuleCollider& a, const PlaneCollider& b, geometry::MeshHits&) {
+		return geometry::intersect(a.getGlobalCapsule(), b.getGlobalPlane());
+	}
+};
+
+template <>
+struct Intersection<CapsuleCollider, MeshCollider> : std::true_type {
+	static bool compute(const CapsuleCollider& a, const MeshCollider& b, geometry::MeshHits& hits) {
+		return geometry::intersect(b.getCollisionMesh(), a.getGlobalCapsule(), hits);
+	}
+};
+
+// how deep the second collider sinks into the first one
+template <class A, class B>
+struct Sinkage : std::false_type {};
+
+template <>
+struct Sinkage<SphereCollider, SphereCollider> : std::true_type {
+	static float compute(const SphereCollider& a, const SphereCollider& b, const geometry::MeshHits&) {
+		return geometry::getSinkage(a.getGlobalSphere(), b.getGlobalSphere());
+	}
+};
+
+template <>
+struct Sinkage<SphereCollider, PlaneCollider> : std::true_type {
+	static float compute(const SphereCollider& a, const PlaneCollider& b, const geometry::MeshHits&) {
+		return geometry::getSinkage(a.getGlobalSphere(), b.getGlobalPlane());
+	}
+};
+
+template <>
+struct Sinkage<MeshCollider, SphereCollider> : std::true_type {
+	// over the triangles the intersection test of the pair found
+	static float compute(const MeshCollider&, const SphereCollider& b, const geometry::MeshHits& hits) {
+		float sum = 0.f;
+		for (size_t i = 0; i < hits.triangles.size(); ++i) {
+			sum += geometry::getSinkage(hits.triangles[i], hits.normals[i], b.getGlobalSphere());
+		}
+		return sum / static_cast<float>(hits.triangles.size());
+	}
+};
+
+template <>
+struct Sinkage<CapsuleCollider, SphereCollider> : std::true_type {
+	static float compute(const CapsuleCollider& a, const SphereCollider& b, const geometry::MeshHits&) {
+		return geometry::getSinkage(a.getGlobalCapsule(), b.getGlobalSphere());
+	}
+};
+
+template <>
+struct Sinkage<CapsuleCollider, CapsuleCollider> : std::true_type {
+	static float compute(const CapsuleCollider& a, const CapsuleCollider& b, const geometry::MeshHits&) {
+		return geometry::getSinkage(a.getGlobalCapsule(), b.getGlobalCapsule());
+	}
+};
+
+template <>
+struct Sinkage<CapsuleCollider, PlaneCollider> : std::true_type {
+	static float compute(const CapsuleCollider& a, const PlaneCollider& b, const geometry::MeshHits&) {
+		return geometry::getSinkage(a.getGlobalCapsule(), b.getGlobalPlane());
+	}
+};
+
+template <>
+struct Sinkage<MeshCollider, CapsuleCollider> : std::true_type {
+	// over the triangles the intersection test of the pair found
+	static float compute(const MeshCollider&, const CapsuleCollider& b, const geometry::MeshHits& hits) {
+		float sum = 0.f;
+		for (size_t i = 0; i < hits.triangles.size(); ++i) {
+			sum += geometry::getSinkage(hits.triangles[i], hits.normals[i], b.getGlobalCapsule());
+		}
+		return sum / static_cast<float>(hits.triangles.size());
+	}
+};
+
+// builds a (typeA, typeB) table from a kernel, swapping arguments of symmetric pairs
+template <template <class, class> class Kernel, class Result, class Hits>
+struct DispatchTable {
+	using Function = Result(*)(const Collider&, const Collider&, Hits);
+	using Table = std::array<std::array<Function, NUM_TYPES>, NUM_TYPES>;
+
+	template <class A, class B>
+	static Result direct(const Collider& a, const Collider& b, Hits hits) {
+		return Kernel<A, B>::compute(static_cast<const A&>(a), static_cast<const B&>(b), hits);
+	}
+
+	template <class A, class B>
+	static Result swapped(const Collider& a, const Collider& b, Hits hits) {
+		return Kernel<B, A>::compute(static_cast<const B&>(b), static_cast<const A&>(a), hits);
+	}
+
+	template <class A, class B, bool S>
+	static constexpr Function select(std::true_type, std::integral_constant<bool, S>) {
+		return &direct<A, B>;
+	}
+
+	template <class A, class B>
+	static constexpr Function select(std::false_type, std::true_type) {
+		return &swapped<A, B>;
+	}
+
+	template <class A, class B>
+	static constexpr Function select(std::false_type, std::false_type) {
+		return nullptr;
+	}
+
+	template <size_t I, size_t... J>
+	static constexpr std::array<Function, NUM_TYPES> makeRow(std::index_sequence<J...>) {
+		return{{select<ColliderOf<I>, ColliderOf<J>>(
+			Kernel<ColliderOf<I>, ColliderOf<J>>(), Kernel<ColliderOf<J>, ColliderOf<I>>())...}};
+	}
+
+	template <size_t... I>
+	static constexpr Table make(std::index_sequence<I...>) {
+		return{{makeRow<I>(std::make_index_sequence<NUM_TYPES>())...}};
+	}
+};
+
+using IntersectionTable = DispatchTable<Intersection, bool, geometry::MeshHits&>;
+using SinkageTable = DispatchTable<Sinkage, float, const geometry::MeshHits&>;
+
+constexpr auto INTERSECTION_KERNELS = IntersectionTable::make(std::make_index_sequence<NUM_TYPES>());
+constexpr auto SINKAGE_KERNELS = SinkageTable::make(std::make_index_sequence<NUM_TYPES>());
+
+IntersectionTable::Function getIntersectionKernel(Type a, Type b) {
+	return INTERSECTION_KERNELS[static_cast<size_t>(a)][static_cast<size_t>(b)];
+}
+
+SinkageTable::Function getSinkageKernel(Type a, Type b) {
+	return SINKAGE_KERNELS[static_cast<size_t>(a)][static_cast<size_t>(b)];
+}
+
+constexpr Collider::TypeMask makePairableTypes(size_t a) {
+	Collider::TypeMask mask = 0;
+	for (size_t b = 0; b < NUM_TYPES; ++b) {
+		if (INTERSECTION_KERNELS[a][b] != nullptr) {
+			mask |= Collider::TypeMask(1) << b;
+		}
+	}
+	return mask;
+}
+
+template <size_t... I>
+constexpr std::array<Collider::TypeMask, NUM_TYPES> makePairableTypeTable(std::index_sequence<I...>) {
+	return{{makePairableTypes(I)...}};
+}
+
+constexpr auto PAIRABLE_TYPES = makePairableTypeTable(std::make_index_sequence<NUM_TYPES>());
+static_assert(NUM_TYPES <= sizeof(Collider::TypeMask) * 8, "TypeMask too narrow");
+
+Collider::Serial nextSerial = 0;
+
+}
+
+Collider::Collider(Type type, std::shared_ptr<CollisionShape> shape) :
+	serial_(nextSerial++),
+	type_(type),
+	shape_(shape),
 	dynamicAABB_(false),
-	isGhost_(false) {}
+	isGhost_(false),
+	updated_(false),
+	shapeChanged_(true),
+	transformVersion_(0) {}
 
-Collider::Collider() : Collider(nullptr) {}
+Collider::Collider(Type type) : Collider(type, nullptr) {}
+
+Collider::Serial Collider::getSerial() const {
+	return serial_;
+}
 
-void Collider::registerCallback(const Callback& callback) {
-	callbacks_.emplace_back(callback);
+Collider::Type Collider::getType() const {
+	return type_;
+}
+
+Collider::TypeMask Collider::getPairableTypes(Type type) {
+	return PAIRABLE_TYPES[static_cast<size_t>(type)];
+}
+
+void Collider::registerCallback(const Callback& callback, ContactEventMask events) {
+	callbacks_.emplace_back(callback, events);
 }
 
 void Collider::clearCallbacks() {
 	callbacks_.clear();
 }
 
-void Collider::notifyCollision(std::shared_ptr<Collider> opponent) const {
-	for (const auto callback : callbacks_) {
-		callback(opponent);
+void Collider::notifyCollision(std::shared_ptr<Collider> opponent, ContactEvent event) const {
+	for (const auto& callback : callbacks_) {
+		if (callback.second & event) {
+			callback.first(opponent);
+		}
 	}
 }
 
-bool Collider::hasModel() const {
-	return model_ != nullptr;
+bool Collider::hasShape() const {
+	return shape_ != nullptr;
 }
 
 void Collider::setDynamicAABB(bool dynamic) {
 	dynamicAABB_ = dynamic;
+	updated_ = false;
 }
 
 void Collider::update() {
-	if (hasModel()) {
-		if (dynamicAABB_ && model_->hasSkinnedMesh()) {
-			geometry::AABB localAABB;
-			localAABB.min = glm::vec3(INFINITY);
-			localAABB.max = glm::vec3(-INFINITY);
-			for (const auto mesh : model_->getMeshes()) {
-				if (const auto skinned = std::dynamic_pointer_cast<SkinnedMesh>(mesh)) {
-					for (const auto& vert : skinned->getTransformAppliedVertices()) {
-						localAABB.min = glm::min(localAABB.min, vert);
-						localAABB.max = glm::max(localAABB.max, vert);
-					}
-				} else {
-					for (const auto& vert : mesh->getVertices()) {
-						localAABB.min = glm::min(localAABB.min, vert);
-						localAABB.max = glm::max(localAABB.max, vert);
-					}
-				}
-			}
-			globalAABB_ = localAABB.transform(getEntity().getModelMatrix());
-		} else {
-			globalAABB_ = model_->getLocalAABB().transform(getEntity().getModelMatrix());
-		}
+	const auto version = getEntity().getTransformVersion();
+	const bool animated = hasShape() && dynamicAABB_ && shape_->isAnimated();
+	shapeChanged_ = !updated_ || version != transformVersion_ || animated;
+	updated_ = true;
+	transformVersion_ = version;
+	if (!shapeChanged_) {
+		return;
+	}
+
+	if (hasShape()) {
+		const auto& localAABB = animated ? shape_->getAnimatedLocalAABB() : shape_->getLocalAABB();
+		globalAABB_ = localAABB.transform(getEntity().getModelMatrix());
 	}
 }
 
-glm::vec3 Collider::getSinkageCorrector(std::shared_ptr<Collider> collider) const {
-	const auto normal = glm::normalize(getNormal(collider->getEntity().getPosition()));
-	if (glm::any(glm::isnan(normal))) {
+glm::vec3 Collider::getSinkageCorrector(const Collider& collider, const geometry::MeshHits& hits) const {
+	const auto kernel = getSinkageKernel(type_, collider.type_);
+	if (!kernel) {
 		return glm::zero<glm::vec3>();
 	}
 
-	float sinkage;
-	if (const auto a = std::dynamic_pointer_cast<AABBCollider>(collider)) {
-		sinkage = getSinkage(a);
-	} else if (const auto s = std::dynamic_pointer_cast<SphereCollider>(collider)) {
-		sinkage = getSinkage(s);
-	} else if (const auto p = std::dynamic_pointer_cast<PlaneCollider>(collider)) {
-		sinkage = getSinkage(p);
-	} else if (const auto m = std::dynamic_pointer_cast<MeshCollider>(collider)) {
-		sinkage = getSinkage(m);
-	} else {
-		throw std::exception("unreachable");
+	// a mesh has no normal of its own, only those of the triangles it is touched on
+	const auto normal = glm::normalize(hits.empty() ?
+		getNormal(collider.getEntity().getPosition()) : hits.getAverageNormal());
+	if (glm::any(glm::isnan(normal))) {
+		return glm::zero<glm::vec3>();
 	}
+
+	const auto sinkage = kernel(*this, collider, hits);
 	if (std::isnan(sinkage)) {
 		return glm::zero<glm::vec3>();
 	}
@@ -84,32 +308,43 @@ glm::vec3 Collider::getSinkageCorrector(std::shared_ptr<Collider> collider) cons
 	return sinkage * normal;
 }
 
-bool Collider::intersects(std::shared_ptr<Collider> collider) const {
-	if (!(getEntity().getFilterMask() & collider->getEntity().getSelfMask())) {
-		return false;
-	}
+bool Collider::intersects(const Collider& collider) const {
+	return (getEntity().getFilterMask() & collider.getEntity().getSelfMask()) && overlaps(collider);
+}
 
-	if (const auto a = std::dynamic_pointer_cast<AABBCollider>(collider)) {
-		return intersectsImpl(a);
-	} else if (const auto s = std::dynamic_pointer_cast<SphereCollider>(collider)) {
-		return intersectsImpl(s);
-	} else if (const auto p = std::dynamic_pointer_cast<PlaneCollider>(collider)) {
-		return intersectsImpl(p);
-	} else if (const auto m = std::dynamic_pointer_cast<MeshCollider>(collider)) {
-		return intersectsImpl(m);
-	}
-	throw std::exception("unreachable");
+bool Collider::overlaps(const Collider& collider) const {
+	geometry::MeshHits hits;
+	return overlaps(collider, hits);
+}
+
+bool Collider::overlaps(const Collider& collider, geometry::MeshHits& hits) const {
+	hits.clear();
+	const auto kernel = getIntersectionKernel(type_, collider.type_);
+	assert(kernel); // callers are expected to pair only supported types
+	return kernel && kernel(*this, collider, hits);
 }
 
-std::shared_ptr<Model> Collider::getModel() const {
-	assert(model_);
-	return model_;
+std::shared_ptr<CollisionShape> Collider::getShape() const {
+	assert(shape_);
+	return shape_;
+}
+
+bool Collider::isShapeChanged() const {
+	return shapeChanged_;
+}
+
+bool Collider::isUpdated() const {
+	return updated_;
 }
 
 const geometry::AABB& Collider::getGlobalAABB() const {
 	return globalAABB_;
 }
 
+geometry::AABB Collider::getBroadphaseAABB() const {
+	return globalAABB_;
+}
+
 void Collider::setGhost(bool isGhost) {
 	isGhost_ = isGhost;
 }
@@ -118,28 +353,40 @@ bool Collider::isGhost() const {
 	return isGhost_;
 }
 
-bool AABBCollider::intersectsImpl(std::shared_ptr<AABBCollider> collider) const {
-	return geometry::intersect(getGlobalAABB(), collider->getGlobalAABB());
+AABBCollider::AABBCollider() : Collider(Type::AABB) {}
+
+AABBCollider::AABBCollider(std::shared_ptr<CollisionShape> shape) : Collider(Type::AABB, shape) {}
+
+bool AABBCollider::raycast(const geometry::Ray& ray, float& distance) const {
+	return geometry::intersect(ray, globalAABB_, distance);
 }
 
-SphereCollider::SphereCollider(std::shared_ptr<Model> model) :
-	Collider(model),
+bool AABBCollider::overlapsSphere(const geometry::Sphere& sphere) const {
+	return geometry::intersect(globalAABB_, sphere);
+}
+
+SphereCollider::SphereCollider(std::shared_ptr<CollisionShape> shape) :
+	Collider(Type::Sphere, shape),
 	radiusFixed_(false),
 	globalSphere_{glm::zero<glm::vec3>(), 0.f}  {}
 
-SphereCollider::SphereCollider(std::shared_ptr<Model> model, float radius) :
-	Collider(model),
+SphereCollider::SphereCollider(std::shared_ptr<CollisionShape> shape, float radius) :
+	Collider(Type::Sphere, shape),
 	radiusFixed_(true),
 	globalSphere_{glm::zero<glm::vec3>(), radius}  {}
 
 SphereCollider::SphereCollider(float radius) :
+	Collider(Type::Sphere),
 	radiusFixed_(true),
 	globalSphere_{glm::zero<glm::vec3>(), radius}  {}
 
 void SphereCollider::update() {
 	Collider::update();
+	if (!isShapeChanged()) {
+		return;
+	}
 
-	if (hasModel()) {
+	if (hasShape()) {
 		const auto& aabb = getGlobalAABB();
 		globalSphere_.center = (aabb.max + aabb.min) / 2.f;
 
@@ -159,32 +406,91 @@ glm::vec3 SphereCollider::getNormal(const glm::vec3& refPos) const {
 	return glm::normalize(refPos - globalSphere_.center);
 }
 
-bool SphereCollider::intersectsImpl(std::shared_ptr<SphereCollider> collider) const {
-	return geometry::intersect(globalSphere_, collider->getGlobalSphere());
+bool SphereCollider::raycast(const geometry::Ray& ray, float& distance) const {
+	return geometry::intersect(ray, globalSphere_, distance);
 }
 
-float SphereCollider::getSinkage(std::shared_ptr<SphereCollider> collider) const {
-	return geometry::getSinkage(globalSphere_, collider->getGlobalSphere());
+bool SphereCollider::overlapsSphere(const geometry::Sphere& sphere) const {
+	return geometry::intersect(globalSphere_, sphere);
 }
 
-bool SphereCollider::intersectsImpl(std::shared_ptr<PlaneCollider> collider) const {
-	return geometry::intersect(globalSphere_, collider->getGlobalPlane());
+geometry::AABB SphereCollider::getBroadphaseAABB() const {
+	// fixed radius may exceed the shape's AABB
+	const auto rv = glm::vec3(globalSphere_.radius);
+	return{
+		glm::min(globalAABB_.min, globalSphere_.center - rv),
+		glm::max(globalAABB_.max, globalSphere_.center + rv)
+	};
 }
 
-float SphereCollider::getSinkage(std::shared_ptr<PlaneCollider> collider) const {
-	return geometry::getSinkage(globalSphere_, collider->getGlobalPlane());
+const geometry::Sphere& SphereCollider::getGlobalSphere() const {
+	return globalSphere_;
 }
 
-bool SphereCollider::intersectsImpl(std::shared_ptr<MeshCollider> collider) const {
-	return geometry::intersect(collider->getCollisionMesh(), globalSphere_);
+CapsuleCollider::CapsuleCollider(std::shared_ptr<CollisionShape> shape) :
+	Collider(Type::Capsule, shape),
+	axis_(0) {
+
+	const auto& aabb = shape->getLocalAABB();
+	const auto center = (aabb.max + aabb.min) / 2.f;
+	const auto halfExtent = (aabb.max - aabb.min) / 2.f;
+	if (halfExtent.y > halfExtent[axis_]) {
+		axis_ = 1;
+	}
+	if (halfExtent.z > halfExtent[axis_]) {
+		axis_ = 2;
+	}
+
+	localCapsule_.r = std::min(halfExtent[(axis_ + 1) % 3], halfExtent[(axis_ + 2) % 3]);
+	auto offset = glm::zero<glm::vec3>();
+	offset[axis_] = std::max(0.f, halfExtent[axis_] - localCapsule_.r);
+	localCapsule_.a = center - offset;
+	localCapsule_.b = center + offset;
+	globalCapsule_ = localCapsule_;
 }
 
-const geometry::Sphere& SphereCollider::getGlobalSphere() const {
-	return globalSphere_;
+void CapsuleCollider::update() {
+	Collider::update();
+	if (!isShapeChanged()) {
+		return;
+	}
+
+	const auto& modelMatrix = getEntity().getModelMatrix();
+	globalCapsule_.a = (modelMatrix * glm::vec4(localCapsule_.a, 1)).xyz();
+	globalCapsule_.b = (modelMatrix * glm::vec4(localCapsule_.b, 1)).xyz();
+
+	// the cross section stays round, so take the larger scale across the axis
+	const glm::mat3 linear(modelMatrix);
+	globalCapsule_.r = localCapsule_.r * std::max(
+		glm::length(linear[(axis_ + 1) % 3]), glm::length(linear[(axis_ + 2) % 3]));
+}
+
+glm::vec3 CapsuleCollider::getNormal(const glm::vec3& refPos) const {
+	return glm::normalize(refPos - globalCapsule_.getClosestPointOnAxis(refPos));
+}
+
+bool CapsuleCollider::raycast(const geometry::Ray& ray, float& distance) const {
+	return geometry::intersect(ray, globalCapsule_, distance);
+}
+
+bool CapsuleCollider::overlapsSphere(const geometry::Sphere& sphere) const {
+	return geometry::intersect(globalCapsule_, sphere);
+}
+
+geometry::AABB CapsuleCollider::getBroadphaseAABB() const {
+	const auto rv = glm::vec3(globalCapsule_.r);
+	return{
+		glm::min(globalCapsule_.a, globalCapsule_.b) - rv,
+		glm::max(globalCapsule_.a, globalCapsule_.b) + rv
+	};
+}
+
+const geometry::Capsule& CapsuleCollider::getGlobalCapsule() const {
+	return globalCapsule_;
 }
 
-PlaneCollider::PlaneCollider(std::shared_ptr<Model> model, const glm::vec3& normal) :
-	Collider(model),
+PlaneCollider::PlaneCollider(std::shared_ptr<CollisionShape> shape, const glm::vec3& normal) :
+	Collider(Type::Plane, shape),
 	globalPlane_({normal, 0}),
 	offset_(0.f) {}
 
@@ -200,8 +506,17 @@ glm::vec3 PlaneCollider::getNormal(const glm::vec3&) const {
 	return globalPlane_.normal;
 }
 
-bool PlaneCollider::intersectsImpl(std::shared_ptr<SphereCollider> collider) const {
-	return geometry::intersect(collider->getGlobalSphere(), globalPlane_);
+bool PlaneCollider::raycast(const geometry::Ray& ray, float& distance) const {
+	return geometry::intersect(ray, globalPlane_, distance);
+}
+
+bool PlaneCollider::overlapsSphere(const geometry::Sphere& sphere) const {
+	return geometry::intersect(sphere, globalPlane_);
+}
+
+geometry::AABB PlaneCollider::getBroadphaseAABB() const {
+	// half-space
+	return{glm::vec3(-INFINITY), glm::vec3(INFINITY)};
 }
 
 const geometry::Plane& PlaneCollider::getGlobalPlane() const {
@@ -212,69 +527,59 @@ void PlaneCollider::setOffset(float offset) {
 	offset_ = offset;
 }
 
-float PlaneCollider::getSinkage(std::shared_ptr<SphereCollider> collider) const {
-	return geometry::getSinkage(collider->getGlobalSphere(), globalPlane_);
-}
-
-FloorCollider::FloorCollider(std::shared_ptr<Model> model) :
-	PlaneCollider(model, glm::vec3(0, 0, 1)) {}
+FloorCollider::FloorCollider(std::shared_ptr<CollisionShape> shape) :
+	PlaneCollider(shape, glm::vec3(0, 0, 1)) {}
 
 void FloorCollider::update() {
 	Collider::update();
 	globalPlane_.d = -offset_;
 }
 
-MeshCollider::MeshCollider(std::shared_ptr<Model> model) : Collider(model) {
-	size_t numTriangles = 0;
-	for (auto mesh : model->getMeshes()) {
-		const auto& indices = mesh->getIndices();
-
-		assert(indices.size() % 3 == 0);
-		numTriangles += indices.size() / 3;
-
-#if _DEBUG
-		for (const auto& triangle : mesh->getTriangles()) {
-			assert(!triangle.isDegenerate());
-		}
-#endif
-	}
-	collisionMesh_.triangles.reserve(numTriangles);
+MeshCollider::MeshCollider(std::shared_ptr<CollisionShape> shape) : Collider(Type::Mesh, shape) {
+	collisionMesh_.bvh = shape->getCollisionBVH();
+	collisionMesh_.uniformScale = 0.f;
 }
 
 void MeshCollider::update() {
 	Collider::update();
-
-	const auto& modelMat = getEntity().getModelMatrix();
-	collisionMesh_.triangles.clear();
-	for (const auto mesh : getModel()->getMeshes()) {
-		for (const auto& triangle : mesh->getTriangles()) {
-			collisionMesh_.triangles.emplace_back(triangle.transform(modelMat));
-		}
+	if (isShapeChanged()) {
+		collisionMesh_.modelMatrix = getEntity().getModelMatrix();
+		collisionMesh_.inverseModelMatrix = glm::inverse(collisionMesh_.modelMatrix);
+
+		const glm::mat3 linear(collisionMesh_.modelMatrix);
+		const auto scale = glm::length(linear[0]);
+		const auto isUniform = glm::determinant(linear) > 0.f
+			&& glm::abs(glm::length(linear[1]) - scale) <= scale * 1e-4f
+			&& glm::abs(glm::length(linear[2]) - scale) <= scale * 1e-4f;
+		collisionMesh_.uniformScale = isUniform ? scale : 0.f;
+
+		updateStaticBounds();
 	}
 }
 
-glm::vec3 MeshCollider::getNormal(const glm::vec3&) const {
-	auto sum = glm::zero<glm::vec3>();
-	for (const auto& triangle : collisionMesh_.collisionTriangles) {
-		sum += triangle.getNormal();
+void MeshCollider::updateStaticBounds() {
+	// the first update() adds them. the entity removes them once this collider is destroyed
+	if (!isUpdated()) {
+		return;
+	}
+	if (getEntity().getSelfMask() & Entity::Mask::StaticObject) {
+		getChunk().updateStaticBounds(*this, globalAABB_);
+	} else {
+		getChunk().removeStaticBounds(*this);
 	}
-	return sum / static_cast<float>(collisionMesh_.collisionTriangles.size());
 }
 
-bool MeshCollider::intersectsImpl(std::shared_ptr<SphereCollider> collider) const {
-	return geometry::intersect(collisionMesh_, collider->getGlobalSphere());
+bool MeshCollider::raycast(const geometry::Ray& ray, float& distance) const {
+	return geometry::intersect(ray, collisionMesh_, distance);
 }
 
-geometry::CollisionMesh& MeshCollider::getCollisionMesh() const {
-	return collisionMesh_;
+bool MeshCollider::overlapsSphere(const geometry::Sphere& sphere) const {
+	geometry::MeshHits hits;
+	return geometry::intersect(collisionMesh_, sphere, hits);
 }
 
-float MeshCollider::getSinkage(std::shared_ptr<SphereCollider> collider) const {
-	float sum = 0.f;
-	for (const auto& triangle : collisionMesh_.collisionTriangles) {
-		sum += geometry::getSinkage(triangle, collider->getGlobalSphere());
-	}
-	return sum / static_cast<float>(collisionMesh_.collisionTriangles.size());
+const geometry::CollisionMesh& MeshCollider::getCollisionMesh() const {
+	return collisionMesh_;
 }
 
 }
@@ -0,0 +1,73 @@
+#include "ContactCache.h"
+
+namespace islands {
+namespace physics {
+
+ContactCache::ContactCache() : step_(0) {}
+
+void ContactCache::beginStep() {
+	++step_;
+	current_.clear();
+	exits_.clear();
+}
+
+ContactCache::Contact& ContactCache::add(const std::shared_ptr<Collider>& a, const std::shared_ptr<Collider>& b) {
+	if (a->getSerial() > b->getSerial()) {
+		return add(b, a);
+	}
+	const Key key(a->getSerial(), b->getSerial());
+	auto iter = contacts_.find(key);
+	const bool isNew = iter == contacts_.end();
+	if (isNew) {
+		iter = contacts_.emplace(key, Contact{a, b, key.first, key.second,
+			Collider::ContactEvent::Enter, {}, glm::zero<glm::vec3>(), glm::zero<glm::vec3>(), step_}).first;
+	}
+	auto& contact = iter->second;
+	assert(isNew || contact.step != step_);
+
+	contact.event = isNew ? Collider::ContactEvent::Enter : Collider::ContactEvent::Stay;
+	contact.correctorA = contact.correctorB = glm::zero<glm::vec3>();
+	contact.step = step_;
+	current_.emplace_back(&contact);
+	return contact;
+}
+
+void ContactCache::endStep() {
+	for (auto iter = contacts_.begin(); iter != contacts_.end();) {
+		if (iter->second.step != step_) {
+			exits_.emplace_back(std::move(iter->second));
+			exits_.back().event = Collider::ContactEvent::Exit;
+			iter = contacts_.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+
+	// the order of contacts_ depends on the history of the hash table
+	std::sort(exits_.begin(), exits_.end(), [](const Contact& x, const Contact& y) {
+		return Key(x.serialA, x.serialB) < Key(y.serialA, y.serialB);
+	});
+}
+
+const std::vector<ContactCache::Contact*>& ContactCache::getContacts() const {
+	return current_;
+}
+
+const std::vector<ContactCache::Contact>& ContactCache::getExits() const {
+	return exits_;
+}
+
+void ContactCache::clear() {
+	contacts_.clear();
+	current_.clear();
+	exits_.clear();
+}
+
+size_t ContactCache::KeyHash::operator()(const Key& key) const {
+	const std::hash<Collider::Serial> hash;
+	const auto h = hash(key.first);
+	return h ^ (hash(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+}
+}
@@ -1,5 +1,7 @@
 #include "Effect.h"
 #include "Camera.h"
+#include "Window.h"
+#include "SimulationClock.h"
 
 namespace islands {
 namespace effect {
@@ -14,15 +16,15 @@ void Damage::start() {
 	material->setUpdateUniformCallback([this](std::shared_ptr<Program> program) {
 		program->use();
 		program->setUniform("MVP", getEntity().calculateMVPMatrix());
-		program->setUniform("time", static_cast<glm::float32>(glfwGetTime() - startedAt_));
+		program->setUniform("time", static_cast<glm::float32>(SimulationClock::getInstance().getTime() - startedAt_));
 	});
 	drawer_->pushMaterial(material);
 
-	startedAt_ = glfwGetTime();
+	startedAt_ = SimulationClock::getInstance().getTime();
 }
 
 void Damage::update() {
-	if (glfwGetTime() - startedAt_ > duration_) {
+	if (SimulationClock::getInstance().getTime() - startedAt_ > duration_) {
 		drawer_->popMaterial();
 		destroy();
 	}
@@ -40,18 +42,18 @@ void Scatter::start() {
 	material->setFragmentShader(Shader::createOrGet("scatter.frag", Shader::Type::Fragment));
 	material->setUpdateUniformCallback([this](std::shared_ptr<Program> program) {
 		program->use();
-		program->setUniform("M", getEntity().getModelMatrix());
-		program->setUniform("MV", Camera::getInstance().getViewMatrix() * getEntity().getModelMatrix());
+		program->setUniform("M", getEntity().getRenderMatrix());
+		program->setUniform("MV", Camera::getInstance().getViewMatrix() * getEntity().getRenderMatrix());
 		program->setUniform("VP", Camera::getInstance().getViewProjectionMatrix());
-		program->setUniform("time", static_cast<glm::float32>(2.0 * (glfwGetTime() - startedAt_)));
+		program->setUniform("time", static_cast<glm::float32>(2.0 * (SimulationClock::getInstance().getTime() - startedAt_)));
 	});
 	drawer_->pushMaterial(material);
 
-	startedAt_ = glfwGetTime();
+	startedAt_ = SimulationClock::getInstance().getTime();
 }
 
 void Scatter::update() {
-	if (glfwGetTime() - startedAt_ > 1.0) {
+	if (SimulationClock::getInstance().getTime() - startedAt_ > 1.0) {
 		drawer_->popMaterial();
 		callback_();
 		destroy();
@@ -65,9 +67,9 @@ void Sea::start() {
 	material->setVertexShader(Shader::createOrGet("sea.vert", Shader::Type::Vertex));
 	material->setUpdateUniformCallback([this](std::shared_ptr<Program> program) {
 		program->use();
-		program->setUniform("M", getEntity().getModelMatrix());
+		program->setUniform("M", getEntity().getRenderMatrix());
 		program->setUniform("VP", Camera::getInstance().getViewProjectionMatrix());
-		program->setUniform("time", static_cast<glm::float32>(glfwGetTime()));
+		program->setUniform("time", static_cast<glm::float32>(Window::getInstance().getTime()));
 	});
 	drawer_->pushMaterial(material);
 }
@@ -76,20 +78,20 @@ void Sea::update() {}
 
 void SwimRing::start() {
 	initPos_ = getEntity().getPosition();
-	startedAt_ = glfwGetTime();
+	startedAt_ = SimulationClock::getInstance().getTime();
 }
 
 void SwimRing::update() {
-	getEntity().setPosition(initPos_ + glm::vec3(0, 0, 0.3f * std::sin(glfwGetTime() - startedAt_)));
+	getEntity().setPosition(initPos_ + glm::vec3(0, 0, 0.3f * std::sin(SimulationClock::getInstance().getTime() - startedAt_)));
 }
 
 void Fish::start() {
 	initPos_ = getEntity().getPosition();
-	startedAt_ = glfwGetTime();
+	startedAt_ = SimulationClock::getInstance().getTime();
 }
 
 void Fish::update() {
-	const auto delta = 0.5 * (glfwGetTime() - startedAt_);
+	const auto delta = 0.5 * (SimulationClock::getInstance().getTime() - startedAt_);
 	getEntity().setQuaternion(geometry::directionToQuaternion({0, std::cos(delta), 0}, {1.f, 0, 0}));
 	getEntity().setPosition(initPos_ + glm::vec3(0, 4.f * std::sin(delta), 0));
 }
@@ -3,10 +3,26 @@
 #include "NameGenerator.h"
 #include "Scene.h"
 #include "Sound.h"
+#include "Replay.h"
 
 namespace islands {
 namespace enemy {
 
+void PlayerHandle::find(const Chunk& chunk) {
+	chunk_ = &chunk;
+	handle_ = chunk.getEntityByName("Player")->getHandle();
+}
+
+std::shared_ptr<Entity> PlayerHandle::get() {
+	assert(chunk_);
+	auto player = chunk_->getEntity(handle_);
+	if (!player) {
+		find(*chunk_);
+		player = chunk_->getEntity(handle_);
+	}
+	return player;
+}
+
 void Slime::start() {
 	getEntity().setSelfMask(Entity::Mask::Enemy);
 	getEntity().setFilterMask(
@@ -19,19 +35,22 @@ void Slime::start() {
 	drawer_ = getEntity().createComponent<ModelDrawer>(model);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	body_ = getEntity().createComponent<PhysicalBody>(collider);
 	health_ = getEntity().createComponent<Health>(3);
 
+	player_.find(getChunk());
 	machine_.changeState<Moving>();
 }
 
@@ -55,7 +74,7 @@ void Slime::Moving::update(Slime& parent) {
 }
 
 void Slime::Turning::start(Slime& parent) {
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = parent.player_.get()->getPosition();
 	parent.direction_ = glm::normalize(playerPos - parent.getEntity().getPosition());
 	parent.direction_.z = 0.f;
 
@@ -95,19 +114,22 @@ void BigSlime::start() {
 	drawer_ = getEntity().createComponent<ModelDrawer>(model);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model, 1.3f);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	body_ = getEntity().createComponent<PhysicalBody>(collider);
 	health_ = getEntity().createComponent<Health>(5);
 
+	player_.find(getChunk());
 	machine_.changeState<Pausing>();
 	drawer_->enableAnimation("", true, 1.0);
 }
@@ -130,7 +152,7 @@ void BigSlime::Jumping::start(BigSlime& parent) {
 	parent.drawer_->enableAnimation("", true, 1.0);
 
 	auto& entity = parent.getEntity();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition().xy();
+	const auto& playerPos = parent.player_.get()->getPosition().xy();
 	const auto diff = playerPos - entity.getPosition().xy();
 	const auto dir = glm::vec3(glm::normalize(diff), 0);
 	entity.setQuaternion(geometry::directionToQuaternion(dir, {0, -1.f, 0}));
@@ -164,19 +186,22 @@ void Rabbit::start() {
 	drawer_->pushMaterial(material);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	body_ = getEntity().createComponent<PhysicalBody>(collider);
 	health_ = getEntity().createComponent<Health>(3);
 
+	player_.find(getChunk());
 	machine_.changeState<Pausing>();
 }
 
@@ -186,7 +211,7 @@ void Rabbit::update() {
 
 void Rabbit::Jumping::start(Rabbit& parent) {
 	const auto& pos = parent.getEntity().getPosition();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = parent.player_.get()->getPosition();
 
 	parent.drawer_->enableAnimation("", false, 3.0, JUMP_ANIM_START_TIME);
 	parent.direction_ = glm::normalize(glm::vec3((playerPos - pos).xy(), 0));
@@ -217,7 +242,7 @@ void Rabbit::Pausing::update(Rabbit& parent) {
 		static constexpr auto ATTACK_RADIUS = 5.f;
 
 		const auto& pos = parent.getEntity().getPosition();
-		const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+		const auto& playerPos = parent.player_.get()->getPosition();
 
 		if (glm::distance(pos, playerPos) < ATTACK_RADIUS) {
 			changeState<PreAttack>();
@@ -282,19 +307,22 @@ void Crab::start() {
 	drawer_->pushMaterial(material);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	body_ = getEntity().createComponent<PhysicalBody>(collider);
 	health_ = getEntity().createComponent<Health>(3);
 
+	player_.find(getChunk());
 	machine_.changeState<Pausing>();
 }
 
@@ -315,7 +343,7 @@ void Crab::Pausing::update(Crab& parent) {
 		static constexpr auto ATTACK_RADIUS = 5.f;
 
 		const auto& pos = parent.getEntity().getPosition();
-		const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+		const auto& playerPos = parent.player_.get()->getPosition();
 		if (glm::distance(pos, playerPos) < ATTACK_RADIUS) {
 			changeState<PreAttack>();
 		} else {
@@ -328,7 +356,7 @@ void Crab::Moving::start(Crab& parent) {
 	parent.drawer_->enableAnimation("", false, 3.0);
 
 	const auto& pos = parent.getEntity().getPosition();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = parent.player_.get()->getPosition();
 
 	parent.direction_ = glm::normalize(
 		glm::vec3((playerPos - pos).xy(), 0));
@@ -383,10 +411,7 @@ void Crab::Attacking::update(Crab& parent) {
 	}
 }
 
-Dragon::Dragon() {
-	std::random_device randomDevice;
-	engine_ = std::mt19937(randomDevice());
-}
+Dragon::Dragon() : engine_(Replay::getInstance().generateSeed()) {}
 
 void Dragon::start() {
 	getEntity().setSelfMask(Entity::Mask::Enemy);
@@ -401,20 +426,23 @@ void Dragon::start() {
 	drawer_->setCullFaceEnabled(false);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	body_ = getEntity().createComponent<PhysicalBody>(collider);
 	body_->setReceiveGravity(false);
 
 	health_ = getEntity().createComponent<Health>(15);
+	player_.find(getChunk());
 
 	drawer_->enableAnimation("", true, 1.0);
 	machine_.changeState<Hovering>();
@@ -494,7 +522,7 @@ void Dragon::PreFire::update(Dragon& parent) {
 
 void Dragon::PostFire::start(Dragon& parent) {
 	const auto& pos = parent.getEntity().getPosition();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = parent.getPlayer()->getPosition();
 
 	const auto attackEntity = parent.getChunk().createEntity(
 		NameGenerator::generate("DragonFire"));
@@ -507,7 +535,7 @@ void Dragon::PostFire::start(Dragon& parent) {
 
 	const auto collider = attackEntity->createComponent<SphereCollider>(1.f);
 	collider->setGhost(true);
-	collider->registerCallback([this, attackEntity](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([attackEntity = attackEntity.get()](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
@@ -562,7 +590,7 @@ void Dragon::Tackling::start(Dragon& parent) {
 	parent.body_->setGhost(true);
 
 	const auto& pos = parent.getEntity().getPosition();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = parent.getPlayer()->getPosition();
 	targetDelta_ = 2.0f * glm::distance(playerPos, pos) / TACKLE_SPEED;
 }
 
@@ -595,9 +623,13 @@ void Dragon::Ascending::update(Dragon& parent) {
 	}
 }
 
+std::shared_ptr<Entity> Dragon::getPlayer() {
+	return player_.get();
+}
+
 void Dragon::lookAtPlayer() {
 	const auto& pos = getEntity().getPosition();
-	const auto& playerPos = getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = getPlayer()->getPosition();
 	direction_ = glm::vec3(glm::normalize(playerPos.xy() - pos.xy()), 0);
 	getEntity().setQuaternion(geometry::directionToQuaternion(direction_, {0, -1.f, 0}));
 }
@@ -624,19 +656,22 @@ void Starfish::start() {
 	drawer_ = getEntity().createComponent<ModelDrawer>(model);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model, 1.f);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	body_ = getEntity().createComponent<PhysicalBody>(collider);
 	health_ = getEntity().createComponent<Health>(3);
 
+	player_.find(getChunk());
 	machine_.changeState<Pausing>();
 }
 
@@ -646,7 +681,7 @@ void Starfish::update() {
 
 void Starfish::Moving::start(Starfish& parent) {
 	const auto& pos = parent.getEntity().getPosition();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+	const auto& playerPos = parent.player_.get()->getPosition();
 
 	parent.drawer_->enableAnimation("", false, 3.0);
 	parent.direction_ = glm::normalize(glm::vec3((playerPos - pos).xy(), 0));
@@ -681,7 +716,7 @@ void Starfish::Pausing::update(Starfish& parent) {
 		static constexpr auto ATTACK_RADIUS = 3.f;
 
 		const auto& pos = parent.getEntity().getPosition();
-		const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition();
+		const auto& playerPos = parent.player_.get()->getPosition();
 
 		if (glm::distance(pos, playerPos) < ATTACK_RADIUS) {
 			changeState<PreAttack>();
@@ -749,25 +784,28 @@ void Eel::start() {
 		meshFilename = "anago_white.dae";
 		break;
 	default:
-		throw std::exception("unreachable");
+		throw std::logic_error("unreachable");
 	}
 	const auto model = Model::createOrGet(meshFilename);
 	drawer_ = getEntity().createComponent<ModelDrawer>(model);
 
 	const auto collider = getEntity().createComponent<SphereCollider>(model, 1.f);
 	collider->setGhost(true);
-	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+	collider->registerCallback([](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	});
+	collider->registerCallback([this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
-	});
+	}, Collider::ContactEvent::Enter);
 
 	health_ = getEntity().createComponent<Health>(3);
 
+	player_.find(getChunk());
 	machine_.changeState<Hiding>();
 }
 
@@ -782,7 +820,7 @@ void Eel::resetToRestPose() {
 }
 
 void Eel::Hiding::update(Eel& parent) {
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition().xy();
+	const auto& playerPos = parent.player_.get()->getPosition().xy();
 	if (glm::distance(parent.getEntity().getPosition().xy(), playerPos) < 10.f) {
 		changeState<Ascending>();
 	}
@@ -818,7 +856,7 @@ void Eel::Idling::update(Eel& parent) {
 		changeState<Dead<Eel>>();
 	} else {
 		const auto& pos = parent.getEntity().getPosition().xy();
-		const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition().xy();
+		const auto& playerPos = parent.player_.get()->getPosition().xy();
 		parent.direction_ = glm::vec3(glm::normalize(playerPos - pos), 0);
 		parent.getEntity().setQuaternion(
 			geometry::directionToQuaternion(parent.direction_, {1.f, 0, 0}));
@@ -873,12 +911,14 @@ void Octopus::start() {
 	getEntity().setSelfMask(Entity::Mask::Enemy);
 	getEntity().setFilterMask(Entity::Mask::PlayerAttack);
 
-	static const auto colliderCallback = [this](std::shared_ptr<Collider> opponent) {
+	const auto colliderCallback = [](std::shared_ptr<Collider> opponent) {
 		const auto& entity = opponent->getEntity();
 		if (entity.getSelfMask() & Entity::Mask::Player) {
 			entity.getFirstComponent<Health>()->takeDamage(1);
 		}
-		if (entity.getSelfMask() & Entity::Mask::PlayerAttack) {
+	};
+	const auto attackedCallback = [this](std::shared_ptr<Collider> opponent) {
+		if (opponent->getEntity().getSelfMask() & Entity::Mask::PlayerAttack) {
 			getEntity().createComponent<effect::Damage>();
 		}
 	};
@@ -889,6 +929,7 @@ void Octopus::start() {
 
 		const auto collider = getEntity().createComponent<SphereCollider>(model, 7.f);
 		collider->registerCallback(colliderCallback);
+		collider->registerCallback(attackedCallback, Collider::ContactEvent::Enter);
 	}
 
 	const auto material = std::make_shared<Material>();
@@ -915,10 +956,12 @@ void Octopus::start() {
 		collider->setGhost(true);
 		collider->setDynamicAABB(true);
 		collider->registerCallback(colliderCallback);
+		collider->registerCallback(attackedCallback, Collider::ContactEvent::Enter);
 	}
 
 	health_ = getEntity().createComponent<Health>(15);
 
+	player_.find(getChunk());
 	machine_.changeState<Idling>();
 }
 
@@ -957,7 +1000,7 @@ void Octopus::Idling::update(Octopus& parent) {
 
 void Octopus::Seeking::start(Octopus& parent) {
 	const auto& pos = parent.getEntity().getPosition().xy();
-	const auto& playerPos = parent.getChunk().getEntityByName("Player")->getPosition().xy();
+	const auto& playerPos = parent.player_.get()->getPosition().xy();
 	targetQuat_ = geometry::directionToQuaternion(glm::vec3(glm::normalize(playerPos - pos), 0), glm::vec3(0, -1.f, 0));
 }
 
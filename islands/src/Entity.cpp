@@ -1,84 +1,140 @@
 #include "Entity.h"
+#include "Chunk.h"
 #include "Component.h"
 #include "Camera.h"
+#include "Collision.h"
 
 namespace islands {
 
-Entity::Entity(const std::string& name, Chunk& chunk) :
+namespace detail {
+
+ComponentTypeId generateComponentTypeId() {
+	static ComponentTypeId nextId = 0;
+	if (nextId >= MAX_COMPONENT_TYPES) {
+		throw std::length_error("too many component types");
+	}
+	return nextId++;
+}
+
+}
+
+constexpr Entity::SlotIndex Entity::NO_SLOT;
+
+Entity::Entity(const Name& name, Chunk& chunk, EntityHandle handle) :
 	name_(name),
 	chunk_(chunk),
-	position_(0),
-	quaternion_(1, 0, 0, 0),
-	scale_(1),
+	handle_(handle),
+	transform_(chunk.getTransforms().create()),
+	renderPosition_(0),
+	renderMatrix_(1.f),
+	hasPrevTransform_(false),
 	selfMask_(0),
 	filterMask_(0),
-	destroyed_(false) {}
+	destroyed_(false) {
 
-const std::string& Entity::getName() const {
+	slotIndices_.fill(NO_SLOT);
+}
+
+Entity::~Entity() {
+	// others may still hold the components, which must not reach back into this entity
+	for (const auto& c : getSlot<Component>()) {
+		c->destroy();
+	}
+	chunk_.getTransforms().destroy(transform_);
+}
+
+const Name& Entity::getName() const {
 	return name_;
 }
 
+EntityHandle Entity::getHandle() const {
+	return handle_;
+}
+
 void Entity::setPosition(const glm::vec3& position) {
-	position_ = position;
-	updateModelMatrix();
+	chunk_.getTransforms().setPosition(transform_, position);
 }
 
-const glm::vec3& Entity::getPosition() const {
-	return position_;
+glm::vec3 Entity::getPosition() const {
+	return chunk_.getTransforms().getPosition(transform_);
 }
 
 void Entity::setQuaternion(const glm::quat& quaternion) {
-	quaternion_ = quaternion;
-	updateModelMatrix();
+	chunk_.getTransforms().setQuaternion(transform_, quaternion);
 }
 
-const glm::quat& Entity::getQuaternion() const {
-	return quaternion_;
+glm::quat Entity::getQuaternion() const {
+	return chunk_.getTransforms().getQuaternion(transform_);
 }
 
 void Entity::setScale(const glm::vec3& scale) {
-	scale_ = scale;
-	updateModelMatrix();
+	chunk_.getTransforms().setScale(transform_, scale);
 }
 
-const glm::vec3& Entity::getScale() const {
-	return scale_;
+glm::vec3 Entity::getScale() const {
+	return chunk_.getTransforms().getScale(transform_);
 }
 
-const glm::mat4& Entity::getModelMatrix() const {
-	return modelMatrix_;
+glm::mat4 Entity::getModelMatrix() const {
+	return chunk_.getTransforms().getModelMatrix(transform_);
 }
 
 glm::mat4 Entity::calculateMVPMatrix() const {
-	return Camera::getInstance().getViewProjectionMatrix() * modelMatrix_;
+	return Camera::getInstance().getViewProjectionMatrix() * renderMatrix_;
 }
 
-void Entity::update() {
-	cleanComponents();
-	for (const auto c : components_) {
-		c->startAndUpdate();
+void Entity::interpolate(float alpha) {
+	auto& transforms = chunk_.getTransforms();
+	const auto& position = transforms.getPosition(transform_);
+	const auto& quaternion = transforms.getQuaternion(transform_);
+	const auto& scale = transforms.getScale(transform_);
+	if (!hasPrevTransform_ || (prevPosition_ == position &&
+		prevQuaternion_ == quaternion && prevScale_ == scale)) {
+
+		renderPosition_ = position;
+		renderMatrix_ = transforms.getModelMatrix(transform_);
+		return;
 	}
+
+	renderPosition_ = glm::mix(prevPosition_, position, alpha);
+	renderMatrix_ = glm::scale(
+		glm::translate(glm::mat4(1.f), renderPosition_) *
+		glm::mat4_cast(glm::slerp(prevQuaternion_, quaternion, alpha)),
+		glm::mix(prevScale_, scale, alpha));
+}
+
+void Entity::snapTransform() {
+	hasPrevTransform_ = false;
+}
+
+const glm::vec3& Entity::getRenderPosition() const {
+	return renderPosition_;
+}
+
+const glm::mat4& Entity::getRenderMatrix() const {
+	return renderMatrix_;
+}
+
+Entity::TransformVersion Entity::getTransformVersion() const {
+	return chunk_.getTransforms().getVersion(transform_);
+}
+
+void Entity::beginUpdate() {
+	const auto& transforms = chunk_.getTransforms();
+	prevPosition_ = transforms.getPosition(transform_);
+	prevQuaternion_ = transforms.getQuaternion(transform_);
+	prevScale_ = transforms.getScale(transform_);
+	hasPrevTransform_ = true;
+
 	cleanComponents();
 }
 
-void Entity::drawOpaque() const {
-	for (const auto c : components_) {
-		if (const auto drawable = std::dynamic_pointer_cast<Drawable>(c)) {
-			if (drawable->isOpaque()) {
-				drawable->startAndDraw();
-			}
-		}
-	}
+void Entity::endUpdate() {
+	cleanComponents();
 }
 
-void Entity::drawTransparent() const {
-	for (const auto c : components_) {
-		if (const auto drawable = std::dynamic_pointer_cast<Drawable>(c)) {
-			if (!drawable->isOpaque()) {
-				drawable->startAndDraw();
-			}
-		}
-	}
+void Entity::invalidateDrawable(const Drawable& drawable) {
+	chunk_.invalidateDrawable(drawable);
 }
 
 Chunk& Entity::getChunk() const {
@@ -86,7 +142,13 @@ Chunk& Entity::getChunk() const {
 }
 
 void Entity::setSelfMask(MaskType mask) {
+	const bool wasStatic = (selfMask_ & Mask::StaticObject) != 0;
 	selfMask_ = mask;
+	if (wasStatic != ((mask & Mask::StaticObject) != 0)) {
+		for (const auto collider : getComponents<MeshCollider>()) {
+			collider->updateStaticBounds();
+		}
+	}
 }
 
 Entity::MaskType Entity::getSelfMask() const {
@@ -109,21 +171,62 @@ bool Entity::isDestroyed() {
 	return destroyed_;
 }
 
-void Entity::updateModelMatrix() {
-	modelMatrix_ = glm::scale(
-		glm::translate(glm::mat4(1.f), position_) * glm::mat4_cast(quaternion_), scale_);
-	/* above does the same as below
-	const auto translation = glm::translate(glm::mat4(1.f), position_);
-	const auto rotation = glm::mat4_cast(quaternion_);
-	const auto scaling = glm::scale(glm::mat4(1.f), scale_);
-	modelMatrix_ = translation * rotation * scaling;*/
+std::shared_ptr<MemoryPools> Entity::getMemoryPools() const {
+	return chunk_.getMemoryPools();
+}
+
+void Entity::registerComponent(std::shared_ptr<Component> component, detail::ComponentTypeId typeId,
+	UpdateScheduler::UpdateFunction updateFunction, UpdatePhase phase) {
+
+	chunk_.getUpdateScheduler().add(component, typeId, updateFunction, phase);
+}
+
+void Entity::addDrawable(std::shared_ptr<Drawable> drawable) {
+	chunk_.addDrawable(drawable);
+}
+
+void Entity::addToSlot(detail::ComponentTypeId typeId, std::shared_ptr<Component> component) {
+	auto& index = slotIndices_[typeId];
+	if (index == NO_SLOT) {
+		index = static_cast<SlotIndex>(slots_.size());
+		slots_.emplace_back();
+	}
+	slots_[index].emplace_back(component);
+	componentTypes_.set(typeId);
+}
+
+const std::vector<std::shared_ptr<Component>>& Entity::getSlot(detail::ComponentTypeId typeId) const {
+	static const std::vector<std::shared_ptr<Component>> EMPTY;
+
+	const auto index = slotIndices_[typeId];
+	return index != NO_SLOT ? slots_[index] : EMPTY;
 }
 
 void Entity::cleanComponents() {
-	components_.erase(std::remove_if(components_.begin(), components_.end(), [](std::shared_ptr<Component> c) {
+	const auto isDestroyed = [](const std::shared_ptr<Component>& c) {
 		return c->isDestroyed();
-	}), components_.end());
+	};
+	const auto& all = getSlot<Component>();
+	if (std::none_of(all.begin(), all.end(), isDestroyed)) {
+		return;
+	}
 
+	// before the pool can reuse the address of the collider for another one
+	for (const auto collider : getComponents<MeshCollider>()) {
+		if (collider->isDestroyed()) {
+			chunk_.removeStaticBounds(*collider);
+		}
+	}
+	for (detail::ComponentTypeId typeId = 0; typeId < detail::MAX_COMPONENT_TYPES; ++typeId) {
+		if (!componentTypes_.test(typeId)) {
+			continue;
+		}
+		auto& components = slots_[slotIndices_[typeId]];
+		components.erase(std::remove_if(components.begin(), components.end(), isDestroyed), components.end());
+		if (components.empty()) {
+			componentTypes_.reset(typeId);
+		}
+	}
 }
 
 }
@@ -2,6 +2,7 @@
 #include "Entity.h"
 #include "PhysicalBody.h"
 #include "Health.h"
+#include "Model.h"
 
 namespace islands {
 
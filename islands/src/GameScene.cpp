@@ -1,9 +1,16 @@
 #include "GameScene.h"
+#include "ChunkLoader.h"
 #include "PhysicalBody.h"
 #include "Health.h"
 #include "Scene.h"
 #include "AssetArchive.h"
 #include "Log.h"
+#include "Physics.h"
+#include "Window.h"
+#include "Camera.h"
+#include "Input.h"
+#include "Replay.h"
+#include "SimulationClock.h"
 
 namespace islands {
 
@@ -31,13 +38,32 @@ std::uint64_t cantorPair(std::uint64_t a, std::uint64_t b) {
 	}
 }
 
+// FNV-1a of what a diverging replay shows first: where the player is and how healthy
+std::uint64_t hashState(const glm::ivec3& coord, const Entity& player) {
+	std::uint64_t hash = 0xcbf29ce484222325;
+	const auto combine = [&hash](const void* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= static_cast<const unsigned char*>(data)[i];
+			hash *= 0x100000001b3;
+		}
+	};
+
+	const auto position = player.getPosition();
+	const auto health = player.getFirstComponent<Health>()->get();
+	combine(&coord, sizeof(coord));
+	combine(&position, sizeof(position));
+	combine(&health, sizeof(health));
+	return hash;
+}
+
 }
 
 GameScene::GameScene(const std::string& levelFilename) :
 	backgroundProgram_(Program::createOrGet("BackgroundProgram",
 		Program::ShaderList{
 			Shader::createOrGet("full_screen.vert", Shader::Type::Vertex),
-			Shader::createOrGet("background.frag", Shader::Type::Fragment)})) {
+			Shader::createOrGet("background.frag", Shader::Type::Fragment)})),
+	tickAccumulator_(0.f) {
 
 	picojson::value json;
 	{
@@ -51,6 +77,10 @@ GameScene::GameScene(const std::string& levelFilename) :
 #endif
 	}
 
+	// before the first update of the chunks, which already steps physics
+	physics::setTickRate(json.contains("tick_rate") ?
+		static_cast<float>(json.get("tick_rate").get<double>()) : 60.f);
+
 	for (const auto& item : json.get("chunks").get<picojson::array>()) {
 		const auto& obj = item.get<picojson::object>();
 
@@ -65,6 +95,7 @@ GameScene::GameScene(const std::string& levelFilename) :
 		const auto& filename = obj.at("filename").get<std::string>();
 
 		const auto chunk = std::make_shared<Chunk>(filename);
+		loadChunk(*chunk, filename);
 		chunk->update();
 		chunks_.emplace(coord, chunk);
 	}
@@ -77,16 +108,58 @@ GameScene::GameScene(const std::string& levelFilename) :
 		initPosArray.at(1).get<double>(),
 		initPosArray.at(2).get<double>()
 	});
+	playerEntity_->snapTransform();
+}
+
+GameScene::~GameScene() {
+#ifdef _DEBUG
+	// every entity and component of a chunk is allocated from its memory pools,
+	// so pools outliving the chunks mean that something still holds on to them
+	std::vector<std::weak_ptr<MemoryPools>> pools;
+	for (const auto& pair : chunks_) {
+		pools.emplace_back(pair.second->getMemoryPools());
+	}
+
+	playerEntity_.reset();
+	currentChunk_.reset();
+	chunks_.clear();
+
+	const auto numLeaked = std::count_if(pools.begin(), pools.end(), [](const std::weak_ptr<MemoryPools>& p) {
+		return !p.expired();
+	});
+	if (numLeaked > 0) {
+		SLOG << "GameScene: Entities or components of " << numLeaked << " chunks leaked" << std::endl;
+	}
+	assert(numLeaked == 0);
+#endif
 }
 
 void GameScene::update() {
+	// bounds the simulation cost when frames take long
+	static constexpr size_t MAX_TICKS_PER_FRAME = 4;
+
+	const auto tickDeltaTime = physics::getTickDeltaTime();
+	tickAccumulator_ += Window::getInstance().getDeltaTime();
+	for (size_t i = 0; i < MAX_TICKS_PER_FRAME && tickAccumulator_ >= tickDeltaTime; ++i) {
+		tick();
+		tickAccumulator_ -= tickDeltaTime;
+	}
+	// intentionally drops the time the capped ticks could not catch up with, so that a slow
+	// frame does not make the next one run even more ticks (the spiral of death)
+	tickAccumulator_ = std::min(tickAccumulator_, tickDeltaTime);
+}
+
+void GameScene::tick() {
 	static const std::array<glm::ivec3, 6> NEIGHBOR_OFFSETS{
 		glm::ivec3(-1, 0, 0), glm::ivec3(1, 0, 0),
 		glm::ivec3(0, -1, 0), glm::ivec3(0, 1, 0),
 		glm::ivec3(0, 0, -1), glm::ivec3(0, 0, 1)
 	};
 
+	Input::getInstance().beginTick();
+	SimulationClock::getInstance().advance(physics::getTickDeltaTime());
 	currentChunk_->update();
+	Replay::getInstance().processStateHash(detail::hashState(currentCoord_, *playerEntity_));
 
 	const auto& playerAABB = playerEntity_->getFirstComponent<Collider>()->getGlobalAABB();
 	const auto playerVelocity = glm::normalize(playerEntity_->getFirstComponent<PhysicalBody>()->getVelocity());
@@ -113,6 +186,8 @@ void GameScene::draw() {
 		glDrawArrays(GL_TRIANGLES, 0, 3);
 		glEnable(GL_DEPTH_TEST);
 
+		currentChunk_->interpolate(tickAccumulator_ / physics::getTickDeltaTime());
+		Camera::getInstance().lookAt(playerEntity_->getRenderPosition());
 		currentChunk_->draw();
 
 		healthIndicator_.draw(playerEntity_->getFirstComponent<Health>());
@@ -137,6 +212,7 @@ void GameScene::jumpTo(const glm::ivec3& dest) {
 		nextPlayer->setPosition(playerEntity_->getPosition()
 			+ JUMP_STEP * glm::vec3(dest - currentCoord_));
 		nextPlayer->setQuaternion(playerEntity_->getQuaternion());
+		nextPlayer->snapTransform();
 
 		{
 			const auto current = playerEntity_->getFirstComponent<Health>();
@@ -152,6 +228,9 @@ void GameScene::jumpTo(const glm::ivec3& dest) {
 			currentBGMInstance_ = nextChunk->getBGM()->createInstance();
 			currentBGMInstance_->play(true);
 		}
+
+		// the chunk left behind is paused, so its overlaps are entered again on return
+		currentChunk_->getContactCache().clear();
 		currentChunk_ = nextChunk;
 	} else {
 		currentChunk_ = nextChunk;
@@ -1,4 +1,10 @@
 #include "Geometry.h"
+#include "BVH.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ENABLE_SIMD
+#include <emmintrin.h>
+#endif
 
 namespace islands {
 namespace geometry {
@@ -29,10 +35,11 @@ bool Triangle::isDegenerate() const {
 	const auto b = glm::normalize(v2 - v1);
 	const auto c = glm::normalize(v0 - v2);
 
+	// written so that coincident vertices, whose edges normalize to NaN, count as degenerate
 	static constexpr auto ALMOST_ONE = 1.f - glm::epsilon<float>();
-	return (glm::abs(glm::dot(a, b)) >= ALMOST_ONE)
-		|| (glm::abs(glm::dot(b, c)) >= ALMOST_ONE)
-		|| (glm::abs(glm::dot(c, a)) >= ALMOST_ONE);
+	return !(glm::abs(glm::dot(a, b)) < ALMOST_ONE)
+		|| !(glm::abs(glm::dot(b, c)) < ALMOST_ONE)
+		|| !(glm::abs(glm::dot(c, a)) < ALMOST_ONE);
 }
 
 glm::vec3 Triangle::getNormal() const {
@@ -56,6 +63,176 @@ glm::vec3 Triangle::getCenter() const {
 	return (v0 + v1 + v2) / 3.f;
 }
 
+glm::vec3 Capsule::getClosestPointOnAxis(const glm::vec3& point) const {
+	const auto ab = b - a;
+	const auto lengthSq = glm::dot(ab, ab);
+	if (lengthSq <= glm::epsilon<float>()) {
+		return a;
+	}
+	return a + glm::clamp(glm::dot(point - a, ab) / lengthSq, 0.f, 1.f) * ab;
+}
+
+glm::vec3 Ray::getPoint(float distance) const {
+	return origin + distance * direction;
+}
+
+namespace {
+
+// see Real-Time Collision Detection 5.1.9
+float getDistanceSq(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2) {
+	static constexpr auto EPSILON = glm::epsilon<float>();
+
+	const auto d1 = q1 - p1;
+	const auto d2 = q2 - p2;
+	const auto r = p1 - p2;
+	const auto a = glm::dot(d1, d1);
+	const auto e = glm::dot(d2, d2);
+	const auto f = glm::dot(d2, r);
+
+	float s, t;
+	if (a <= EPSILON && e <= EPSILON) {
+		return glm::dot(r, r);
+	}
+	if (a <= EPSILON) {
+		s = 0.f;
+		t = glm::clamp(f / e, 0.f, 1.f);
+	} else {
+		const auto c = glm::dot(d1, r);
+		if (e <= EPSILON) {
+			t = 0.f;
+			s = glm::clamp(-c / a, 0.f, 1.f);
+		} else {
+			const auto b = glm::dot(d1, d2);
+			const auto denom = a * e - b * b;
+			s = denom != 0.f ? glm::clamp((b * f - c * e) / denom, 0.f, 1.f) : 0.f;
+			t = (b * s + f) / e;
+			if (t < 0.f) {
+				t = 0.f;
+				s = glm::clamp(-c / a, 0.f, 1.f);
+			} else if (t > 1.f) {
+				t = 1.f;
+				s = glm::clamp((b - c) / a, 0.f, 1.f);
+			}
+		}
+	}
+
+	const auto diff = (p1 + d1 * s) - (p2 + d2 * t);
+	return glm::dot(diff, diff);
+}
+
+// see Real-Time Collision Detection 5.1.5
+glm::vec3 getClosestPoint(const Triangle& triangle, const glm::vec3& p) {
+	const auto& a = triangle.v0;
+	const auto& b = triangle.v1;
+	const auto& c = triangle.v2;
+
+	const auto ab = b - a;
+	const auto ac = c - a;
+	const auto ap = p - a;
+	const auto d1 = glm::dot(ab, ap);
+	const auto d2 = glm::dot(ac, ap);
+	if (d1 <= 0.f && d2 <= 0.f) {
+		return a;
+	}
+
+	const auto bp = p - b;
+	const auto d3 = glm::dot(ab, bp);
+	const auto d4 = glm::dot(ac, bp);
+	if (d3 >= 0.f && d4 <= d3) {
+		return b;
+	}
+
+	const auto vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) {
+		return a + d1 / (d1 - d3) * ab;
+	}
+
+	const auto cp = p - c;
+	const auto d5 = glm::dot(ab, cp);
+	const auto d6 = glm::dot(ac, cp);
+	if (d6 >= 0.f && d5 <= d6) {
+		return c;
+	}
+
+	const auto vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) {
+		return a + d2 / (d2 - d6) * ac;
+	}
+
+	const auto va = d3 * d6 - d5 * d4;
+	if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) {
+		return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+	}
+
+	const auto denom = 1.f / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// whether segment pq crosses the triangle
+bool intersectSegment(const Triangle& triangle, const glm::vec3& p, const glm::vec3& q) {
+	const auto n = glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+	const auto dp = glm::dot(n, p - triangle.v0);
+	const auto dq = glm::dot(n, q - triangle.v0);
+	if ((dp > 0.f && dq > 0.f) || (dp < 0.f && dq < 0.f) || dp == dq) {
+		return false;
+	}
+
+	const auto x = p + (dp / (dp - dq)) * (q - p);
+	const auto inside = [&](const glm::vec3& u, const glm::vec3& v) {
+		return glm::dot(n, glm::cross(v - u, x - u)) >= 0.f;
+	};
+	return inside(triangle.v0, triangle.v1) && inside(triangle.v1, triangle.v2) && inside(triangle.v2, triangle.v0);
+}
+
+}
+
+TriangleBatch::TriangleBatch() {
+	// unused lanes stay zeroed and are masked out by count
+	std::memset(this, 0, sizeof(TriangleBatch));
+}
+
+void TriangleBatch::set(size_t lane, const Triangle& triangle) {
+	assert(lane < SIZE);
+	const auto n = triangle.getNormal();
+	const glm::vec3 e[] = {triangle.v1 - triangle.v0, triangle.v2 - triangle.v1, triangle.v0 - triangle.v2};
+	for (glm::length_t axis = 0; axis < 3; ++axis) {
+		v0[axis][lane] = triangle.v0[axis];
+		v1[axis][lane] = triangle.v1[axis];
+		v2[axis][lane] = triangle.v2[axis];
+		normal[axis][lane] = n[axis];
+		for (size_t i = 0; i < 3; ++i) {
+			edges[i][axis][lane] = e[i][axis];
+		}
+	}
+	planeD[lane] = glm::dot(n, triangle.v0);
+	for (size_t i = 0; i < 3; ++i) {
+		edgeLengthSq[i][lane] = glm::dot(e[i], e[i]);
+	}
+	count = std::max(count, static_cast<std::uint32_t>(lane + 1));
+}
+
+glm::vec3 TriangleBatch::getNormal(size_t lane) const {
+	assert(lane < count);
+	return {normal[0][lane], normal[1][lane], normal[2][lane]};
+}
+
+void MeshHits::clear() {
+	triangles.clear();
+	normals.clear();
+}
+
+bool MeshHits::empty() const {
+	return triangles.empty();
+}
+
+glm::vec3 MeshHits::getAverageNormal() const {
+	auto sum = glm::zero<glm::vec3>();
+	for (const auto& normal : normals) {
+		sum += normal;
+	}
+	return sum / static_cast<float>(normals.size());
+}
+
 bool intersect(const AABB& a, const AABB& b) {
 	return glm::all(glm::greaterThanEqual(a.max, b.min)) &&
 		glm::all(glm::lessThanEqual(a.min, b.max));
@@ -134,18 +311,379 @@ bool intersect(const Sphere& sphere, const Plane& plane) {
 	return glm::dot(plane.normal, sphere.center) <= a;
 }
 
-bool intersect(CollisionMesh& mesh, const Sphere& sphere) {
-	bool intersected = false;
-	mesh.collisionTriangles.clear();
-	for (const auto& triangle : mesh.triangles) {
-		if (intersect(triangle, sphere)) {
-			intersected = true;
+bool intersect(const CollisionMesh& mesh, const Sphere& sphere, MeshHits& hits) {
+	assert(mesh.bvh);
+	hits.clear();
+
+	if (mesh.uniformScale > 0.f) {
+		// the sphere stays a sphere in local space, so test against the precomputed batches there
+		const Sphere localSphere{
+			(mesh.inverseModelMatrix * glm::vec4(sphere.center, 1)).xyz(),
+			sphere.radius / mesh.uniformScale
+		};
+		const auto rv = glm::vec3(localSphere.radius);
+		const glm::mat3 normalMatrix(mesh.modelMatrix);
+
+		mesh.bvh->query(AABB{localSphere.center - rv, localSphere.center + rv},
+			[&](const TriangleBatch& batch, const Triangle* triangles) {
+			auto lanes = intersect(batch, localSphere);
+			for (size_t lane = 0; lanes; ++lane, lanes >>= 1) {
+				if (lanes & 1) {
+					hits.triangles.emplace_back(triangles[lane].transform(mesh.modelMatrix));
+					hits.normals.emplace_back(glm::normalize(normalMatrix * batch.getNormal(lane)));
+				}
+			}
+		});
+	} else {
+		// bounds of the sphere in local space, conservative under non-uniform scaling
+		const auto rv = glm::vec3(sphere.radius);
+		const auto localAABB = AABB{sphere.center - rv, sphere.center + rv}.transform(mesh.inverseModelMatrix);
+
+		mesh.bvh->query(localAABB, [&](const TriangleBatch& batch, const Triangle* triangles) {
+			for (size_t lane = 0; lane < batch.count; ++lane) {
+				const auto triangle = triangles[lane].transform(mesh.modelMatrix);
+				if (intersect(triangle, sphere)) {
+					hits.triangles.emplace_back(triangle);
+					hits.normals.emplace_back(triangle.getNormal());
+				}
+			}
+		});
+	}
+
+	return !hits.empty();
+}
+
+bool intersect(const Capsule& capsule, const Sphere& sphere) {
+	assert(capsule.r >= 0.f && sphere.radius >= 0.f);
+	const auto r = capsule.r + sphere.radius;
+	const auto d = sphere.center - capsule.getClosestPointOnAxis(sphere.center);
+	return glm::dot(d, d) <= r * r;
+}
+
+bool intersect(const Capsule& a, const Capsule& b) {
+	assert(a.r >= 0.f && b.r >= 0.f);
+	const auto r = a.r + b.r;
+	return getDistanceSq(a.a, a.b, b.a, b.b) <= r * r;
+}
+
+bool intersect(const Capsule& capsule, const Plane& plane) {
+	assert(capsule.r >= 0.f);
+	const auto a = glm::length(plane.normal) * capsule.r - plane.d;
+	return std::min(glm::dot(plane.normal, capsule.a), glm::dot(plane.normal, capsule.b)) <= a;
+}
+
+bool intersect(const Triangle& triangle, const Capsule& capsule) {
+	assert(!triangle.isDegenerate());
+	assert(capsule.r >= 0.f);
 
-			mesh.collisionTriangles.emplace_back(triangle);
+	if (intersectSegment(triangle, capsule.a, capsule.b)) {
+		return true;
+	}
+
+	// otherwise the closest points lie on an endpoint or on an edge of the triangle
+	const auto rr = capsule.r * capsule.r;
+	for (const auto& p : {capsule.a, capsule.b}) {
+		const auto d = p - getClosestPoint(triangle, p);
+		if (glm::dot(d, d) <= rr) {
+			return true;
+		}
+	}
+	return getDistanceSq(capsule.a, capsule.b, triangle.v0, triangle.v1) <= rr ||
+		getDistanceSq(capsule.a, capsule.b, triangle.v1, triangle.v2) <= rr ||
+		getDistanceSq(capsule.a, capsule.b, triangle.v2, triangle.v0) <= rr;
+}
+
+bool intersect(const CollisionMesh& mesh, const Capsule& capsule, MeshHits& hits) {
+	assert(mesh.bvh);
+	hits.clear();
+
+	const auto rv = glm::vec3(capsule.r);
+	const AABB aabb{glm::min(capsule.a, capsule.b) - rv, glm::max(capsule.a, capsule.b) + rv};
+	mesh.bvh->query(aabb.transform(mesh.inverseModelMatrix), [&](const TriangleBatch& batch, const Triangle* triangles) {
+		for (size_t lane = 0; lane < batch.count; ++lane) {
+			const auto triangle = triangles[lane].transform(mesh.modelMatrix);
+			if (intersect(triangle, capsule)) {
+				hits.triangles.emplace_back(triangle);
+				hits.normals.emplace_back(triangle.getNormal());
+			}
+		}
+	});
+
+	return !hits.empty();
+}
+
+bool intersect(const AABB& aabb, const Sphere& sphere) {
+	const auto d = sphere.center - glm::clamp(sphere.center, aabb.min, aabb.max);
+	return glm::dot(d, d) <= sphere.radius * sphere.radius;
+}
+
+// see Real-Time Collision Detection 5.3.3
+bool intersect(const Ray& ray, const AABB& aabb, float& distance) {
+	auto tMin = 0.f;
+	auto tMax = ray.length;
+	for (glm::length_t axis = 0; axis < 3; ++axis) {
+		if (glm::abs(ray.direction[axis]) <= glm::epsilon<float>()) {
+			if (ray.origin[axis] < aabb.min[axis] || ray.origin[axis] > aabb.max[axis]) {
+				return false;
+			}
+			continue;
+		}
+
+		const auto inv = 1.f / ray.direction[axis];
+		auto t1 = (aabb.min[axis] - ray.origin[axis]) * inv;
+		auto t2 = (aabb.max[axis] - ray.origin[axis]) * inv;
+		if (t1 > t2) {
+			std::swap(t1, t2);
+		}
+		tMin = std::max(tMin, t1);
+		tMax = std::min(tMax, t2);
+		if (tMin > tMax) {
+			return false;
 		}
 	}
-	
-	return intersected;
+	distance = tMin;
+	return true;
+}
+
+// see Real-Time Collision Detection 5.3.2
+bool intersect(const Ray& ray, const Sphere& sphere, float& distance) {
+	const auto m = ray.origin - sphere.center;
+	const auto b = glm::dot(m, ray.direction);
+	const auto c = glm::dot(m, m) - sphere.radius * sphere.radius;
+	if (c > 0.f && b > 0.f) {
+		return false;
+	}
+	const auto disc = b * b - c;
+	if (disc < 0.f) {
+		return false;
+	}
+
+	const auto t = std::max(0.f, -b - glm::sqrt(disc));
+	if (t > ray.length) {
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+bool intersect(const Ray& ray, const Plane& plane, float& distance) {
+	// same half-space as intersect(Sphere, Plane) with zero radius
+	const auto s = glm::dot(plane.normal, ray.origin) + plane.d;
+	if (s <= 0.f) {
+		distance = 0.f;
+		return true;
+	}
+	const auto denom = glm::dot(plane.normal, ray.direction);
+	if (denom >= 0.f) {
+		return false;
+	}
+
+	const auto t = -s / denom;
+	if (t > ray.length) {
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+bool intersect(const Ray& ray, const Capsule& capsule, float& distance) {
+	const auto rr = capsule.r * capsule.r;
+	const auto toAxis = ray.origin - capsule.getClosestPointOnAxis(ray.origin);
+	if (glm::dot(toAxis, toAxis) <= rr) {
+		distance = 0.f;
+		return true;
+	}
+
+	// the first hit is the nearest one among the end spheres and the side
+	auto nearest = INFINITY;
+	float t;
+	if (intersect(ray, Sphere{capsule.a, capsule.r}, t)) {
+		nearest = t;
+	}
+	if (intersect(ray, Sphere{capsule.b, capsule.r}, t)) {
+		nearest = std::min(nearest, t);
+	}
+
+	// infinite cylinder with components along the axis removed
+	const auto ab = capsule.b - capsule.a;
+	const auto abLengthSq = glm::dot(ab, ab);
+	if (abLengthSq > glm::epsilon<float>()) {
+		const auto reject = [&](const glm::vec3& v) {
+			return v - (glm::dot(v, ab) / abLengthSq) * ab;
+		};
+		const auto d = reject(ray.direction);
+		const auto m = reject(ray.origin - capsule.a);
+		const auto a = glm::dot(d, d);
+		const auto b = glm::dot(m, d);
+		const auto c = glm::dot(m, m) - rr;
+		const auto disc = b * b - a * c;
+		if (a > glm::epsilon<float>() && disc >= 0.f) {
+			t = (-b - glm::sqrt(disc)) / a;
+			const auto s = glm::dot(ray.getPoint(t) - capsule.a, ab) / abLengthSq;
+			if (t >= 0.f && t <= ray.length && s >= 0.f && s <= 1.f) {
+				nearest = std::min(nearest, t);
+			}
+		}
+	}
+
+	if (nearest > ray.length) {
+		return false;
+	}
+	distance = nearest;
+	return true;
+}
+
+// Moller-Trumbore, hits both faces
+bool intersect(const Ray& ray, const Triangle& triangle, float& distance) {
+	const auto e1 = triangle.v1 - triangle.v0;
+	const auto e2 = triangle.v2 - triangle.v0;
+	const auto p = glm::cross(ray.direction, e2);
+	const auto det = glm::dot(e1, p);
+	if (glm::abs(det) <= glm::epsilon<float>()) {
+		return false;
+	}
+
+	const auto invDet = 1.f / det;
+	const auto s = ray.origin - triangle.v0;
+	const auto u = glm::dot(s, p) * invDet;
+	if (u < 0.f || u > 1.f) {
+		return false;
+	}
+	const auto q = glm::cross(s, e1);
+	const auto v = glm::dot(ray.direction, q) * invDet;
+	if (v < 0.f || u + v > 1.f) {
+		return false;
+	}
+
+	const auto t = glm::dot(e2, q) * invDet;
+	if (t < 0.f || t > ray.length) {
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+bool intersect(const Ray& ray, const CollisionMesh& mesh, float& distance) {
+	assert(mesh.bvh);
+
+	const auto p = (mesh.inverseModelMatrix * glm::vec4(ray.origin, 1)).xyz();
+	const auto q = (mesh.inverseModelMatrix * glm::vec4(ray.getPoint(ray.length), 1)).xyz();
+	auto nearest = INFINITY;
+	mesh.bvh->query(AABB{glm::min(p, q), glm::max(p, q)}, [&](const TriangleBatch& batch, const Triangle* triangles) {
+		for (size_t lane = 0; lane < batch.count; ++lane) {
+			float t;
+			if (intersect(ray, triangles[lane].transform(mesh.modelMatrix), t)) {
+				nearest = std::min(nearest, t);
+			}
+		}
+	});
+
+	if (nearest > ray.length) {
+		return false;
+	}
+	distance = nearest;
+	return true;
+}
+
+#ifdef ENABLE_SIMD
+
+namespace {
+
+struct Vec3x4 {
+	__m128 x, y, z;
+};
+
+inline Vec3x4 load(const float (&v)[3][TriangleBatch::SIZE]) {
+	return {_mm_loadu_ps(v[0]), _mm_loadu_ps(v[1]), _mm_loadu_ps(v[2])};
+}
+
+inline Vec3x4 operator-(const Vec3x4& a, const Vec3x4& b) {
+	return {_mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z)};
+}
+
+inline Vec3x4 operator*(const Vec3x4& a, __m128 s) {
+	return {_mm_mul_ps(a.x, s), _mm_mul_ps(a.y, s), _mm_mul_ps(a.z, s)};
+}
+
+inline __m128 dot(const Vec3x4& a, const Vec3x4& b) {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+}
+
+// lanes where the sphere is separated by the axis perpendicular to the edge from start
+inline __m128 separatedByEdge(const Vec3x4& start, const Vec3x4& opposite,
+	const Vec3x4& edge, __m128 lengthSq, __m128 rr) {
+
+	const auto d = dot(start, edge);
+	const auto q = start * lengthSq - edge * d;
+	const auto qc = opposite * lengthSq - q;
+	return _mm_and_ps(
+		_mm_cmpgt_ps(dot(q, q), _mm_mul_ps(rr, _mm_mul_ps(lengthSq, lengthSq))),
+		_mm_cmpgt_ps(dot(q, qc), _mm_setzero_ps()));
+}
+
+// lanes where the sphere is separated by the axis through the vertex
+inline __m128 separatedByVertex(__m128 vv, __m128 v1, __m128 v2, __m128 rr) {
+	return _mm_and_ps(_mm_cmpgt_ps(vv, rr), _mm_and_ps(_mm_cmpgt_ps(v1, vv), _mm_cmpgt_ps(v2, vv)));
+}
+
+}
+
+unsigned int intersect(const TriangleBatch& batch, const Sphere& sphere) {
+	assert(sphere.radius >= 0.f);
+
+	const Vec3x4 center{
+		_mm_set1_ps(sphere.center.x), _mm_set1_ps(sphere.center.y), _mm_set1_ps(sphere.center.z)
+	};
+	const auto rr = _mm_set1_ps(sphere.radius * sphere.radius);
+
+	const auto dist = _mm_sub_ps(dot(load(batch.normal), center), _mm_loadu_ps(batch.planeD));
+	auto separated = _mm_cmpgt_ps(_mm_mul_ps(dist, dist), rr);
+
+	const auto a = load(batch.v0) - center;
+	const auto b = load(batch.v1) - center;
+	const auto c = load(batch.v2) - center;
+	const auto aa = dot(a, a);
+	const auto ab = dot(a, b);
+	const auto ac = dot(a, c);
+	const auto bb = dot(b, b);
+	const auto bc = dot(b, c);
+	const auto cc = dot(c, c);
+	separated = _mm_or_ps(separated, separatedByVertex(aa, ab, ac, rr));
+	separated = _mm_or_ps(separated, separatedByVertex(bb, ab, bc, rr));
+	separated = _mm_or_ps(separated, separatedByVertex(cc, ac, bc, rr));
+
+	separated = _mm_or_ps(separated,
+		separatedByEdge(a, c, load(batch.edges[0]), _mm_loadu_ps(batch.edgeLengthSq[0]), rr));
+	separated = _mm_or_ps(separated,
+		separatedByEdge(b, a, load(batch.edges[1]), _mm_loadu_ps(batch.edgeLengthSq[1]), rr));
+	separated = _mm_or_ps(separated,
+		separatedByEdge(c, b, load(batch.edges[2]), _mm_loadu_ps(batch.edgeLengthSq[2]), rr));
+
+	const auto mask = (1u << batch.count) - 1;
+	return ~static_cast<unsigned int>(_mm_movemask_ps(separated)) & mask;
+}
+
+#else
+
+unsigned int intersect(const TriangleBatch& batch, const Sphere& sphere) {
+	return intersectScalar(batch, sphere);
+}
+
+#endif
+
+unsigned int intersectScalar(const TriangleBatch& batch, const Sphere& sphere) {
+	unsigned int hits = 0;
+	for (size_t lane = 0; lane < batch.count; ++lane) {
+		const Triangle triangle{
+			{batch.v0[0][lane], batch.v0[1][lane], batch.v0[2][lane]},
+			{batch.v1[0][lane], batch.v1[1][lane], batch.v1[2][lane]},
+			{batch.v2[0][lane], batch.v2[1][lane], batch.v2[2][lane]}
+		};
+		if (intersect(triangle, sphere)) {
+			hits |= 1u << lane;
+		}
+	}
+	return hits;
 }
 
 float getSinkage(const Triangle& triangle, const Sphere& sphere) {
@@ -155,6 +693,11 @@ float getSinkage(const Triangle& triangle, const Sphere& sphere) {
 	return sphere.radius - dist;
 }
 
+float getSinkage(const Triangle& triangle, const glm::vec3& normal, const Sphere& sphere) {
+	assert(sphere.radius >= 0.f);
+	return sphere.radius - glm::dot(normal, sphere.center - triangle.v0);
+}
+
 float getSinkage(const Sphere& a, const Sphere& b) {
 	assert(a.radius >= 0.f && b.radius >= 0.f);
 	return a.radius + b.radius - glm::distance(a.center, b.center);
@@ -166,6 +709,27 @@ float getSinkage(const Sphere& sphere, const Plane& plane) {
 	return a - glm::dot(plane.normal, sphere.center);
 }
 
+float getSinkage(const Capsule& capsule, const Sphere& sphere) {
+	assert(capsule.r >= 0.f && sphere.radius >= 0.f);
+	return capsule.r + sphere.radius - glm::distance(sphere.center, capsule.getClosestPointOnAxis(sphere.center));
+}
+
+float getSinkage(const Capsule& a, const Capsule& b) {
+	assert(a.r >= 0.f && b.r >= 0.f);
+	return a.r + b.r - std::sqrt(getDistanceSq(a.a, a.b, b.a, b.b));
+}
+
+float getSinkage(const Capsule& capsule, const Plane& plane) {
+	assert(capsule.r >= 0.f);
+	const auto a = glm::length(plane.normal) * capsule.r - plane.d;
+	return a - std::min(glm::dot(plane.normal, capsule.a), glm::dot(plane.normal, capsule.b));
+}
+
+float getSinkage(const Triangle& triangle, const glm::vec3& normal, const Capsule& capsule) {
+	assert(capsule.r >= 0.f);
+	return capsule.r - std::min(glm::dot(normal, capsule.a - triangle.v0), glm::dot(normal, capsule.b - triangle.v0));
+}
+
 glm::quat directionToQuaternion(const glm::vec3& dir, const glm::vec3& front) {
 	if (glm::dot(dir, -front) < 1.f - glm::epsilon<float>()) {
 		return glm::rotation(front, dir);
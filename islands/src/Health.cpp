@@ -1,4 +1,5 @@
 #include "Health.h"
+#include "SimulationClock.h"
 
 namespace islands {
 
@@ -19,7 +20,7 @@ bool Health::takeDamage(HealthType damage) {
 	}
 
 	health_ -= damage;
-	lastDamageTakenAt_ = glfwGetTime();
+	lastDamageTakenAt_ = SimulationClock::getInstance().getTime();
 	return true;
 }
 
@@ -44,7 +45,7 @@ void Health::set(HealthType health) {
 }
 
 bool Health::isInvincible() const {
-	return glfwGetTime() < lastDamageTakenAt_ + invincibleDuration_;
+	return SimulationClock::getInstance().getTime() < lastDamageTakenAt_ + invincibleDuration_;
 }
 
 }
@@ -1,9 +1,14 @@
 #include "Input.h"
 #include "Window.h"
+#include "Replay.h"
 
 namespace islands {
 
-Input::Input() {
+Input::Input() :
+	state_{glm::zero<glm::vec2>(), 0, false, false},
+	pendingCommands_(0),
+	tickCommands_(0) {
+
 	glfwSetKeyCallback(Window::getInstance().getHandle(), [](GLFWwindow*, int key, int, int action, int) {
 		for (const auto callback : getInstance().keyboardCallbacks_) {
 			callback(key, action);
@@ -43,10 +48,28 @@ void Input::update() {
 	}
 
 	if (glm::length2(dir) > glm::epsilon<float>()) {
-		direction_ = glm::normalize(dir);
+		state_.direction = glm::normalize(dir);
 	} else {
-		direction_ = glm::zero<glm::vec2>();
+		state_.direction = glm::zero<glm::vec2>();
 	}
+
+	state_.commands = 0;
+	for (const auto command : {Command::Jump, Command::Attack}) {
+		if (isCommandActiveOnDevices(command)) {
+			state_.commands |= 1 << static_cast<CommandMask>(command);
+		}
+	}
+	state_.anyButtonPressed = anyButtonPressedOnDevices();
+	state_.anyButtonExceptArrowPressed = anyButtonExceptArrowPressedOnDevices();
+
+	Replay::getInstance().processInput(state_);
+	pendingCommands_ |= state_.commands;
+}
+
+void Input::beginTick() {
+	tickCommands_ = pendingCommands_;
+	pendingCommands_ = 0;
+	Replay::getInstance().processTickCommands(tickCommands_);
 }
 
 void Input::registerKeyboardCallback(const KeyboardCallback& callback) {
@@ -54,10 +77,22 @@ void Input::registerKeyboardCallback(const KeyboardCallback& callback) {
 }
 
 const glm::vec2 Input::getDirection() const {
-	return direction_;
+	return state_.direction;
 }
 
 bool Input::isCommandActive(Command command) const {
+	return (tickCommands_ & (1 << static_cast<CommandMask>(command))) != 0;
+}
+
+bool Input::anyButtonPressed() const {
+	return state_.anyButtonPressed;
+}
+
+bool Input::anyButtonExceptArrowPressed() const {
+	return state_.anyButtonExceptArrowPressed;
+}
+
+bool Input::isCommandActiveOnDevices(Command command) const {
 	if (keyboard_.isPresent() && keyboard_.isCommandActive(command)) {
 		return true;
 	} else if (gamepad_.isPresent() && gamepad_.isCommandActive(command)) {
@@ -66,7 +101,7 @@ bool Input::isCommandActive(Command command) const {
 	return false;
 }
 
-bool Input::anyButtonPressed() const {
+bool Input::anyButtonPressedOnDevices() const {
 	if (keyboard_.isPresent() && keyboard_.anyButtonPressed()) {
 		return true;
 	} else if (gamepad_.isPresent() && gamepad_.anyButtonPressed()) {
@@ -75,7 +110,7 @@ bool Input::anyButtonPressed() const {
 	return false;
 }
 
-bool Input::anyButtonExceptArrowPressed() const {
+bool Input::anyButtonExceptArrowPressedOnDevices() const {
 	if (keyboard_.isPresent() && keyboard_.anyButtonExceptArrowPressed()) {
 		return true;
 	} else if (gamepad_.isPresent() && gamepad_.anyButtonExceptArrowPressed()) {
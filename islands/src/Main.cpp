@@ -3,6 +3,8 @@
 #include "Window.h"
 #include "Input.h"
 #include "Scene.h"
+#include "Physics.h"
+#include "Replay.h"
 
 namespace islands {
 
@@ -44,7 +46,7 @@ void printSystemInformation() {
 
 }
 
-int main() {
+int main(int argc, char* argv[]) {
 	using namespace islands;
 
 	glfwSetErrorCallback([](int code, const char* msg) {
@@ -149,6 +151,16 @@ SLOG << "glad(" << name << "): " << #code << std::endl; return;
 
 	SceneManager::getInstance().changeScene<TitleScene>();
 
+	// --record FILE or --replay FILE
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const std::string option = argv[i];
+		if (option == "--record") {
+			Replay::getInstance().startRecording(argv[i + 1]);
+		} else if (option == "--replay") {
+			Replay::getInstance().startPlayback(argv[i + 1]);
+		}
+	}
+
 #ifdef _DEBUG
 	std::ostringstream ss;
 #endif
@@ -172,10 +184,26 @@ SLOG << "glad(" << name << "): " << #code << std::endl; return;
 			", delta: " << Profiler::getInstance().getLastDeltaTime() <<
 			", update: " << Profiler::getInstance().getElapsedTime("update") <<
 			", draw: " << Profiler::getInstance().getElapsedTime("draw");
+		if (Profiler::getInstance().hasSection("physics")) {
+			const auto& stat = physics::getLastStatistics();
+			ss << ", physics: " << static_cast<long long>(1e9 * Profiler::getInstance().getElapsedTime("physics")) <<
+				"ns (" << stat.numColliders << " colliders, " << stat.numCandidatePairs << " pairs, " <<
+				stat.numNarrowphaseTests << " tests, " << stat.numContacts << " contacts, " <<
+				stat.numSleepingBodies << "/" << stat.numBodies << " bodies sleeping)";
+		}
+		for (size_t phase = 0; phase < UpdateScheduler::NUM_PHASES; ++phase) {
+			const auto name = UpdateScheduler::getPhaseName(phase);
+			if (Profiler::getInstance().hasSection(name)) {
+				ss << ", " << name << ": " << static_cast<long long>(1e9 * Profiler::getInstance().getElapsedTime(name)) << "ns";
+			}
+		}
 		glfwSetWindowTitle(Window::getInstance().getHandle(), ss.str().c_str());
 		Profiler::getInstance().clearSamples();
 #endif
 	}
 
+	// rather than relying on the order static instances are destroyed in
+	Replay::getInstance().stop();
+
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,61 @@
+#include "MemoryPool.h"
+
+namespace islands {
+
+MemoryPool::MemoryPool(size_t blockSize) :
+	blockSize_(std::max(blockSize, sizeof(void*))),
+	numUsedInLastPage_(0),
+	freeList_(nullptr) {}
+
+void* MemoryPool::allocate() {
+	if (freeList_) {
+		const auto block = freeList_;
+		freeList_ = *static_cast<void**>(block);
+		return block;
+	}
+
+	if (pages_.empty() || numUsedInLastPage_ == BLOCKS_PER_PAGE) {
+		pages_.emplace_back(new char[blockSize_ * BLOCKS_PER_PAGE]);
+		numUsedInLastPage_ = 0;
+	}
+	return pages_.back().get() + blockSize_ * numUsedInLastPage_++;
+}
+
+void MemoryPool::deallocate(void* block) {
+	// freed blocks hold the link to the next free block
+	*static_cast<void**>(block) = freeList_;
+	freeList_ = block;
+}
+
+void* MemoryPools::allocate(size_t size) {
+	if (size > MAX_BLOCK_SIZE) {
+		return ::operator new(size);
+	}
+
+	const auto index = getPoolIndex(size);
+	if (index >= pools_.size()) {
+		pools_.resize(index + 1);
+	}
+	auto& pool = pools_[index];
+	if (!pool) {
+		pool = std::make_unique<MemoryPool>((index + 1) * GRANULARITY);
+	}
+	return pool->allocate();
+}
+
+void MemoryPools::deallocate(void* p, size_t size) {
+	if (size > MAX_BLOCK_SIZE) {
+		::operator delete(p);
+		return;
+	}
+
+	const auto index = getPoolIndex(size);
+	assert(index < pools_.size() && pools_[index]);
+	pools_[index]->deallocate(p);
+}
+
+size_t MemoryPools::getPoolIndex(size_t size) {
+	return (std::max<size_t>(size, 1) + GRANULARITY - 1) / GRANULARITY - 1;
+}
+
+}
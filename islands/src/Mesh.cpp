@@ -38,6 +38,7 @@ Mesh::Mesh(const aiMesh* mesh, const aiMaterial* material) :
 	Resource(mesh->mName.C_Str()),
 	vertices_(mesh->mNumVertices),
 	normals_(mesh->mNumVertices),
+	localAABB_{glm::vec3(INFINITY), glm::vec3(-INFINITY)},
 	hasUV_(mesh->HasTextureCoords(0)),
 	meshMaterial_(material) {
 
@@ -50,6 +51,8 @@ Mesh::Mesh(const aiMesh* mesh, const aiMaterial* material) :
 	for (size_t i = 0; i < mesh->mNumVertices; ++i) {
 		const auto& pos = mesh->mVertices[i];
 		vertices_.at(i) = {pos.x, pos.y, pos.z};
+		localAABB_.min = glm::min(localAABB_.min, vertices_.at(i));
+		localAABB_.max = glm::max(localAABB_.max, vertices_.at(i));
 
 		const auto& normal = mesh->mNormals[i];
 		normals_.at(i) = {normal.x, normal.y, normal.z};
@@ -118,6 +121,10 @@ std::vector<geometry::Triangle> Mesh::getTriangles() const {
 	return triangles;
 }
 
+const geometry::AABB& Mesh::getLocalAABB() const {
+	return localAABB_;
+}
+
 void Mesh::uploadImpl() {
 	vertexArray_.bind();
 
@@ -173,7 +180,8 @@ glm::quat aiQuaternionToGlmQuat(const aiQuaternion& quat) {
 SkinnedMesh::SkinnedMesh(const aiMesh* mesh, const aiMaterial* material, const aiNode* root,
 	aiAnimation** animations, size_t numAnimations) :
 	Mesh(mesh, material),
-	playingAnim_(nullptr) {
+	playingAnim_(nullptr),
+	hasPartiallyWeightedVertices_(false) {
 
 	assert(mesh->HasBones());
 
@@ -201,6 +209,24 @@ SkinnedMesh::SkinnedMesh(const aiMesh* mesh, const aiMaterial* material, const a
 	}
 	assert(bones_.size() <= NUM_MAX_BONES);
 
+	boneAABBs_.assign(bones_.size(), {glm::vec3(INFINITY), glm::vec3(-INFINITY)});
+	for (size_t i = 0; i < boneData_.size(); ++i) {
+		const auto& vert = getVertices().at(i);
+		float weightSum = 0.f;
+		for (size_t j = 0; j < NUM_BONES_PER_VERTEX; ++j) {
+			const auto weight = boneData_.at(i).weights[j];
+			if (weight > 0.f) {
+				auto& aabb = boneAABBs_.at(boneData_.at(i).boneIDs[j]);
+				aabb.min = glm::min(aabb.min, vert);
+				aabb.max = glm::max(aabb.max, vert);
+				weightSum += weight;
+			}
+		}
+		if (weightSum < 1.f - 1e-3f) {
+			hasPartiallyWeightedVertices_ = true;
+		}
+	}
+
 	for (size_t i = 0; i < numAnimations; ++i) {
 		const auto animation = animations[i];
 		const auto anim = std::make_shared <Animation>();
@@ -271,6 +297,26 @@ std::vector<glm::vec3> SkinnedMesh::getTransformAppliedVertices() const {
 	return verts;
 }
 
+geometry::AABB SkinnedMesh::getTransformAppliedAABB() const {
+	// a skinned vertex is a convex combination of its bones' transforms applied to it,
+	// so it lies within the union of the transformed bone boxes
+	geometry::AABB aabb{glm::vec3(INFINITY), glm::vec3(-INFINITY)};
+	if (hasPartiallyWeightedVertices_) {
+		// weights summing up to less than one pull vertices toward the origin
+		aabb.min = aabb.max = glm::zero<glm::vec3>();
+	}
+	for (size_t i = 0; i < bones_.size(); ++i) {
+		const auto& boneAABB = boneAABBs_[i];
+		if (boneAABB.min.x > boneAABB.max.x) {
+			continue;
+		}
+		const auto transformed = boneAABB.transform(bones_[i]->transform);
+		aabb.min = glm::min(aabb.min, transformed.min);
+		aabb.max = glm::max(aabb.max, transformed.max);
+	}
+	return aabb;
+}
+
 void SkinnedMesh::uploadImpl() {
 	Mesh::uploadImpl();
 
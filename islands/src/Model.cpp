@@ -2,13 +2,16 @@
 #include "Camera.h"
 #include "AssetArchive.h"
 #include "Log.h"
+#include "BVH.h"
+#include "SimulationClock.h"
 
 namespace islands {
 
 Model::Model(const std::string& filename) :
 	SharedResource(filename),
 	opaque_(true),
-	hasSkinned_(false) {}
+	hasSkinned_(false),
+	collisionCooked_(false) {}
 
 const std::vector<std::shared_ptr<Mesh>>& Model::getMeshes() {
 	load();
@@ -26,12 +29,95 @@ bool Model::hasSkinnedMesh() {
 }
 
 const geometry::AABB& Model::getLocalAABB() {
+	// the cooked BVH bounds all triangles, which is enough for collision-only models
+	if (collisionCooked_ && !isLoaded()) {
+		return collisionBVH_->getBounds();
+	}
 	load();
 	return localAABB_;
 }
 
+bool Model::isAnimated() {
+	return hasSkinnedMesh();
+}
+
+geometry::AABB Model::getAnimatedLocalAABB() {
+	load();
+	geometry::AABB aabb;
+	aabb.min = glm::vec3(INFINITY);
+	aabb.max = glm::vec3(-INFINITY);
+	for (const auto mesh : meshes_) {
+		const auto skinned = std::dynamic_pointer_cast<SkinnedMesh>(mesh);
+		const auto meshAABB = skinned ? skinned->getTransformAppliedAABB() : mesh->getLocalAABB();
+		aabb.min = glm::min(aabb.min, meshAABB.min);
+		aabb.max = glm::max(aabb.max, meshAABB.max);
+	}
+	return aabb;
+}
+
+namespace {
+
+const std::string MESH_DIR = "asset/mesh";
+
+std::shared_ptr<const geometry::BVH> loadCookedBVH(const std::string& name) {
+	static const std::string COLLISION_DIR = "asset/collision";
+
+#ifdef ENABLE_ASSET_ARCHIVE
+	// files inside the archive cannot be mapped
+	const auto filePath = COLLISION_DIR + '/' + name + ".bvh";
+	if (!AssetArchive::getInstance().exists(filePath)) {
+		return nullptr;
+	}
+	const auto data = std::make_shared<std::vector<char>>(AssetArchive::getInstance().readFile(filePath));
+	const std::shared_ptr<const char> blob(data, data->data());
+	const auto size = data->size();
+#else
+	const auto filePath = COLLISION_DIR + sys::getFilePathSeparator() + name + ".bvh";
+	const auto file = std::make_shared<sys::MappedFile>(filePath);
+	if (!file->isOpen()) {
+		return nullptr;
+	}
+	const std::shared_ptr<const char> blob(file, file->getData());
+	const auto size = file->getSize();
+#endif
+
+	SLOG << "Loading cooked collision " << filePath << std::endl;
+	try {
+		// the cooker rewrites blobs older than their meshes at build time,
+		// so the mesh itself is not read here
+		return std::make_shared<geometry::BVH>(blob, size);
+	} catch (const std::invalid_argument& e) {
+		SLOG << "Ignoring " << filePath << ": " << e.what() << std::endl;
+		return nullptr;
+	}
+}
+
+}
+
+std::shared_ptr<const geometry::BVH> Model::getCollisionBVH() {
+	if (!collisionBVH_) {
+		collisionBVH_ = loadCookedBVH(getName());
+		collisionCooked_ = collisionBVH_ != nullptr;
+	}
+	if (!collisionBVH_) {
+		load();
+		std::vector<geometry::Triangle> triangles;
+		for (const auto mesh : meshes_) {
+			assert(mesh->getIndices().size() % 3 == 0);
+
+			// as the collision cooker does, since their normals would be NaN
+			for (const auto& triangle : mesh->getTriangles()) {
+				if (!triangle.isDegenerate()) {
+					triangles.emplace_back(triangle);
+				}
+			}
+		}
+		collisionBVH_ = std::make_shared<geometry::BVH>(std::move(triangles));
+	}
+	return collisionBVH_;
+}
+
 void Model::loadImpl() {
-	static const std::string MESH_DIR = "asset/mesh";
 	static const auto FLAGS = aiProcess_GenNormals | aiProcess_ImproveCacheLocality |
 		aiProcess_JoinIdenticalVertices | aiProcess_LimitBoneWeights | aiProcess_OptimizeMeshes |
 		aiProcess_RemoveComponent |	aiProcess_Triangulate;
@@ -99,7 +185,7 @@ ModelDrawer::ModelDrawer(std::shared_ptr<Model> model) :
 }
 
 void ModelDrawer::update() {
-	const auto elapsedTime = static_cast<float>(glfwGetTime() - anim_.startTime)
+	const auto elapsedTime = static_cast<float>(SimulationClock::getInstance().getTime() - anim_.startTime)
 		+ anim_.startFrame / (24.0 * anim_.tps);
 
 	if (anim_.playing) {
@@ -170,7 +256,7 @@ bool ModelDrawer::isOpaque() const {
 	case Material::Opaqueness::InheritModel:
 		return model_->isOpaque();
 	default:
-		throw std::exception("unreachable");
+		throw std::logic_error("unreachable");
 	}
 }
 
@@ -188,11 +274,13 @@ void ModelDrawer::setCullFaceEnabled(bool enabled) {
 
 void ModelDrawer::pushMaterial(std::shared_ptr<Material> material) {
 	materialStack_.push(material);
+	notifyOpaquenessChanged();
 }
 
 std::shared_ptr<Material> ModelDrawer::popMaterial() {
 	const auto material = materialStack_.top();
 	materialStack_.pop();
+	notifyOpaquenessChanged();
 	return material;
 }
 
@@ -202,7 +290,7 @@ void ModelDrawer::enableAnimation(const std::string& name, bool loop, double tps
 		anim_.playing = true;
 		anim_.loop = loop;
 		anim_.tps = tps;
-		anim_.startTime = glfwGetTime();
+		anim_.startTime = SimulationClock::getInstance().getTime();
 		anim_.startFrame = startFrame;
 		for (const auto mesh : model_->getMeshes()) {
 			if (const auto skinned = std::dynamic_pointer_cast<SkinnedMesh>(mesh)) {
@@ -226,7 +314,7 @@ bool ModelDrawer::isPlayingAnimation() const {
 
 size_t ModelDrawer::getCurrentAnimationFrame() const {
 	return anim_.startFrame
-		+ static_cast<size_t>(24.0 * anim_.tps * (glfwGetTime() - anim_.startTime));
+		+ static_cast<size_t>(24.0 * anim_.tps * (SimulationClock::getInstance().getTime() - anim_.startTime));
 }
 
 };
@@ -0,0 +1,91 @@
+#include "Name.h"
+
+namespace islands {
+
+namespace {
+
+class SymbolTable {
+public:
+	SymbolTable(const SymbolTable&) = delete;
+	SymbolTable& operator=(const SymbolTable&) = delete;
+	virtual ~SymbolTable() = default;
+
+	static SymbolTable& getInstance() {
+		static SymbolTable instance;
+		return instance;
+	}
+
+	std::uint32_t intern(const std::string& str) {
+		const auto iter = symbols_.find(str);
+		if (iter != symbols_.end()) {
+			return iter->second;
+		}
+		const auto symbol = static_cast<std::uint32_t>(strings_.size());
+		strings_.emplace_back(str);
+		symbols_.emplace(str, symbol);
+		return symbol;
+	}
+
+	const std::string& getString(std::uint32_t symbol) const {
+		return strings_.at(symbol);
+	}
+
+	// interns the string of a generated name the first time it is requested
+	const std::string& getGeneratedString(std::uint32_t prefix, std::uint32_t serial) {
+		const auto key = static_cast<std::uint64_t>(serial) << 32 | prefix;
+		auto iter = generated_.find(key);
+		if (iter == generated_.end()) {
+			const auto str = std::to_string(serial - 1) + "_" + getString(prefix);
+			iter = generated_.emplace(key, intern(str)).first;
+		}
+		return getString(iter->second);
+	}
+
+private:
+	std::unordered_map<std::string, std::uint32_t> symbols_;
+
+	// deque so that references to the strings stay valid
+	std::deque<std::string> strings_;
+
+	std::unordered_map<std::uint64_t, std::uint32_t> generated_;
+
+	SymbolTable() {
+		intern("");
+	}
+};
+
+}
+
+Name::Name() :
+	symbol_(0),
+	serial_(0) {}
+
+Name::Name(const char* str) :
+	symbol_(SymbolTable::getInstance().intern(str)),
+	serial_(0) {}
+
+Name::Name(const std::string& str) :
+	symbol_(SymbolTable::getInstance().intern(str)),
+	serial_(0) {}
+
+Name Name::generate(const Name& prefix, std::uint32_t serial) {
+	assert(prefix.serial_ == 0);
+	Name name;
+	name.symbol_ = prefix.symbol_;
+	name.serial_ = serial + 1;
+	return name;
+}
+
+const std::string& Name::str() const {
+	auto& table = SymbolTable::getInstance();
+	if (serial_ == 0) {
+		return table.getString(symbol_);
+	}
+	return table.getGeneratedString(symbol_, serial_);
+}
+
+std::ostream& operator<<(std::ostream& os, const Name& name) {
+	return os << name.str();
+}
+
+}
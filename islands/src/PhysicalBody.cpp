@@ -1,14 +1,17 @@
 #include "PhysicalBody.h"
-#include "Window.h"
+#include "Physics.h"
 
 namespace islands {
 
 PhysicalBody::PhysicalBody(std::shared_ptr<Collider> collider = nullptr) :
+	collider_(collider),
 	mass_(1.f),
 	velocity_(0.f),
-	collider_(collider),
 	receiveGravity_(true),
-	isGhost_(false) {}
+	isGhost_(false),
+	sleeping_(false),
+	restingSteps_(0),
+	sleepTransformVersion_(0) {}
 
 void PhysicalBody::update() {}
 
@@ -27,10 +30,13 @@ void PhysicalBody::setMass(float mass) {
 
 void PhysicalBody::setVelocity(const glm::vec3& velocity) {
 	velocity_ = velocity;
+	if (velocity_ != glm::zero<glm::vec3>()) {
+		wakeUp();
+	}
 }
 
 void PhysicalBody::addVelocity(const glm::vec3& velocity) {
-	velocity_ += velocity;
+	setVelocity(velocity_ + velocity);
 }
 
 const glm::vec3& PhysicalBody::getVelocity() const {
@@ -41,12 +47,13 @@ void PhysicalBody::moveBy(const glm::vec3& offset) const {
 	getEntity().setPosition(getEntity().getPosition() + offset);
 }
 
-void PhysicalBody::stepForward() const {
-	moveBy(Window::getInstance().getDeltaTime() * velocity_);
+void PhysicalBody::stepForward(const glm::vec3& acceleration) {
+	velocity_ += physics::getTickDeltaTime() * acceleration;
+	moveBy(physics::getTickDeltaTime() * velocity_);
 }
 
 void PhysicalBody::applyImpulse(const glm::vec3& impulse) {
-	velocity_ += impulse / mass_;
+	setVelocity(velocity_ + impulse / mass_);
 }
 
 void PhysicalBody::setReceiveGravity(bool receive) {
@@ -65,4 +72,41 @@ bool PhysicalBody::isGhost() const {
 	return isGhost_;
 }
 
+bool PhysicalBody::isSleeping() const {
+	return sleeping_;
+}
+
+bool PhysicalBody::isMoving() const {
+	return !sleeping_ && restingSteps_ == 0;
+}
+
+void PhysicalBody::wakeUp() {
+	sleeping_ = false;
+	restingSteps_ = 0;
+}
+
+void PhysicalBody::sleepIfResting(const glm::vec3& displacement) {
+	static constexpr size_t STEPS_TO_SLEEP = 30;
+	static constexpr float MAX_RESTING_SPEED = 0.05f;
+	static constexpr float MAX_RESTING_DISPLACEMENT = 1e-3f;
+
+	assert(!sleeping_);
+	if (glm::length(velocity_) > MAX_RESTING_SPEED ||
+		glm::length(displacement) > MAX_RESTING_DISPLACEMENT) {
+
+		restingSteps_ = 0;
+		return;
+	}
+
+	if (++restingSteps_ >= STEPS_TO_SLEEP) {
+		sleeping_ = true;
+		velocity_ = glm::zero<glm::vec3>();
+		sleepTransformVersion_ = getEntity().getTransformVersion();
+	}
+}
+
+bool PhysicalBody::isMovedWhileSleeping() const {
+	return sleeping_ && getEntity().getTransformVersion() != sleepTransformVersion_;
+}
+
 }
@@ -1,20 +1,39 @@
 #include "Physics.h"
+#include "Broadphase.h"
+#include "ContactCache.h"
 #include "Collision.h"
 #include "PhysicalBody.h"
 #include "Entity.h"
-#include "Window.h"
 
 namespace islands {
 
 namespace physics {
 
-void update(const Chunk& chunk) {
+namespace {
+
+Statistics statistics;
+float tickDeltaTime = 1.f / 60;
+
+}
+
+void setTickRate(float ticksPerSecond) {
+	assert(ticksPerSecond > 0.f);
+	tickDeltaTime = 1.f / ticksPerSecond;
+}
+
+float getTickDeltaTime() {
+	return tickDeltaTime;
+}
+
+void update(Chunk& chunk) {
 	static const glm::vec3 GRAVITY(0, 0, -36.f);
 	static constexpr float FRICTION = 3.f;
+	auto& broadphase = chunk.getBroadphase();
 
 	std::vector<std::shared_ptr<PhysicalBody>> bodies;
-	std::vector<std::shared_ptr<Collider>> colliders;
-	for (const auto entity : chunk.getEntities()) {
+	auto& colliders = broadphase.getColliders();
+	colliders.clear();
+	for (const auto& entity : chunk.getEntities()) {
 		for (const auto body : entity->getComponents<PhysicalBody>()) {
 			bodies.emplace_back(body);
 		}
@@ -23,61 +42,177 @@ void update(const Chunk& chunk) {
 		}
 	}
 
-	for (const auto body : bodies) {
-		auto v = body->getVelocity();
-		if (body->getReceiveGravity()) {
-			v += GRAVITY * Window::getInstance().getDeltaTime();
+	// bodies awake at the start of this step and where they were
+	std::vector<bool> awake(bodies.size(), false);
+	std::vector<glm::vec3> startPositions(bodies.size());
+	for (size_t i = 0; i < bodies.size(); ++i) {
+		const auto& body = bodies[i];
+		if (body->isMovedWhileSleeping()) {
+			body->wakeUp();
+		}
+		if (body->isSleeping()) {
+			continue;
 		}
-		body->setVelocity(v);
-		body->stepForward();
+		awake[i] = true;
+		startPositions[i] = body->getEntity().getPosition();
+
+		body->stepForward(body->getReceiveGravity() ? GRAVITY : glm::zero<glm::vec3>());
 	}
 
-	for (const auto collider : colliders) {
+	chunk.getTransforms().updateMatrices();
+	for (const auto& collider : colliders) {
 		collider->update();
 	}
 
-	for (const auto collider : colliders) {
-		for (const auto c : colliders) {
-			if (&c->getEntity() == &collider->getEntity()) {
-				continue;
-			}
-			if (collider->intersects(c)) {
-				collider->notifyCollision(c);
-			}
+	broadphase.update();
+	const auto& pairs = broadphase.getPairs();
+
+	statistics.numColliders = colliders.size();
+	statistics.numCandidatePairs = pairs.size();
+	statistics.numNarrowphaseTests = 0;
+
+	// body index for each collider that gets pushed out of overlaps
+	std::unordered_map<const Collider*, size_t> colliderToBody;
+	for (size_t i = 0; i < bodies.size(); ++i) {
+		const auto& body = bodies[i];
+		if (body->hasCollider() && !body->isGhost()) {
+			colliderToBody.emplace(body->getCollider().get(), i);
 		}
 	}
+	const auto findBody = [&](const Collider& collider) -> PhysicalBody* {
+		const auto iter = colliderToBody.find(&collider);
+		return iter != colliderToBody.end() ? bodies[iter->second].get() : nullptr;
+	};
+	const auto isPushedOut = [&](const Collider& self, const Collider& opponent) {
+		if (opponent.isGhost() || !(self.getEntity().getFilterMask() & opponent.getEntity().getSelfMask())) {
+			return false;
+		}
+		const auto body = findBody(self);
+		return body && !body->isSleeping();
+	};
 
-	for (const auto body : bodies) {
-		if (body->hasCollider() && !body->isGhost()) {
-			bool frictionCollide = false;
-			const auto collider = body->getCollider();
-			for (const auto c : colliders) {
-				if (&c->getEntity() == &collider->getEntity()) {
-					continue;
-				}
-				if (!c->isGhost() && collider->intersects(c)) {
-					body->moveBy(c->getSinkageCorrector(collider));
+	// sleeping bodies wake up on a new contact, when a moving body touches them
+	// and when a contact ends, e.g. because what they rest on went away
+	const auto wakeUpByContact = [&](const ContactCache::Contact& contact,
+		const Collider* colliderA, const Collider* colliderB) {
 
-					if (c->getEntity().getSelfMask() != Entity::Mask::CollisionWall) {
-						frictionCollide = true;
-					}
-				}
-			}
-			if (frictionCollide) {
-				auto v = body->getVelocity();
-				for (glm::length_t i = 0; i < v.length(); ++i) {
-					if (v[i] > FRICTION) {
-						v[i] -= FRICTION;
-					} else if (v[i] < -FRICTION) {
-						v[i] += FRICTION;
-					} else {
-						v[i] = 0;
-					}
+		// destroyed colliders have no body in colliderToBody
+		const auto a = colliderA ? findBody(*colliderA) : nullptr;
+		const auto b = colliderB ? findBody(*colliderB) : nullptr;
+		const bool changed = contact.event != Collider::ContactEvent::Stay;
+		if (a && (changed || (b && b->isMoving()))) {
+			a->wakeUp();
+		}
+		if (b && (changed || (a && a->isMoving()))) {
+			b->wakeUp();
+		}
+	};
+
+	auto& contactCache = chunk.getContactCache();
+	contactCache.beginStep();
+	geometry::MeshHits hits;
+	for (const auto& pair : pairs) {
+		const Collider* a = colliders[pair.first].get();
+		const Collider* b = colliders[pair.second].get();
+		++statistics.numNarrowphaseTests;
+		if (!a->overlaps(*b, hits)) {
+			continue;
+		}
+
+		// the hits stay with the contact, whose a is the collider with the smaller serial.
+		// copied into its vectors rather than swapped so that both keep their capacity
+		auto& contact = contactCache.add(colliders[pair.first], colliders[pair.second]);
+		contact.meshHits.triangles.assign(hits.triangles.begin(), hits.triangles.end());
+		contact.meshHits.normals.assign(hits.normals.begin(), hits.normals.end());
+		if (a->getSerial() > b->getSerial()) {
+			std::swap(a, b);
+		}
+		wakeUpByContact(contact, a, b);
+		if (isPushedOut(*a, *b)) {
+			contact.correctorA = b->getSinkageCorrector(*a, contact.meshHits);
+		}
+		if (isPushedOut(*b, *a)) {
+			contact.correctorB = a->getSinkageCorrector(*b, contact.meshHits);
+		}
+	}
+	contactCache.endStep();
+	statistics.numContacts = contactCache.getContacts().size();
+
+	const auto notify = [](const ContactCache::Contact& contact,
+		const std::shared_ptr<Collider>& a, const std::shared_ptr<Collider>& b) {
+
+		if (a->getEntity().getFilterMask() & b->getEntity().getSelfMask()) {
+			a->notifyCollision(b, contact.event);
+		}
+		if (b->getEntity().getFilterMask() & a->getEntity().getSelfMask()) {
+			b->notifyCollision(a, contact.event);
+		}
+	};
+	for (const auto contact : contactCache.getContacts()) {
+		notify(*contact, contact->a.lock(), contact->b.lock());
+	}
+	for (const auto& contact : contactCache.getExits()) {
+		const auto a = contact.a.lock();
+		const auto b = contact.b.lock();
+		wakeUpByContact(contact, a.get(), b.get());
+
+		// the entity of a destroyed collider may be gone already
+		if (a && b && !a->isDestroyed() && !b->isDestroyed()) {
+			notify(contact, a, b);
+		}
+	}
+
+	std::vector<bool> frictionCollide(bodies.size(), false);
+	const auto correct = [&](const Collider& self, const Collider& opponent, const glm::vec3& corrector) {
+		if (!isPushedOut(self, opponent)) {
+			return;
+		}
+
+		const auto bodyIndex = colliderToBody.at(&self);
+		bodies[bodyIndex]->moveBy(corrector);
+		if (opponent.getEntity().getSelfMask() != Entity::Mask::CollisionWall) {
+			frictionCollide[bodyIndex] = true;
+		}
+	};
+	for (const auto contact : contactCache.getContacts()) {
+		const auto a = contact->a.lock();
+		const auto b = contact->b.lock();
+		correct(*a, *b, contact->correctorA);
+		correct(*b, *a, contact->correctorB);
+	}
+
+	for (size_t b = 0; b < bodies.size(); ++b) {
+		if (frictionCollide[b]) {
+			const auto& body = bodies[b];
+			auto v = body->getVelocity();
+			for (glm::length_t i = 0; i < v.length(); ++i) {
+				if (v[i] > FRICTION) {
+					v[i] -= FRICTION;
+				} else if (v[i] < -FRICTION) {
+					v[i] += FRICTION;
+				} else {
+					v[i] = 0;
 				}
-				body->setVelocity(v);
 			}
+			body->setVelocity(v);
 		}
 	}
+
+	statistics.numBodies = bodies.size();
+	statistics.numSleepingBodies = 0;
+	for (size_t i = 0; i < bodies.size(); ++i) {
+		const auto& body = bodies[i];
+		if (awake[i] && !body->isSleeping()) {
+			body->sleepIfResting(body->getEntity().getPosition() - startPositions[i]);
+		}
+		if (body->isSleeping()) {
+			++statistics.numSleepingBodies;
+		}
+	}
+}
+
+const Statistics& getLastStatistics() {
+	return statistics;
 }
 
 }
@@ -1,5 +1,4 @@
 #include "Player.h"
-#include "Camera.h"
 #include "Input.h"
 #include "Chunk.h"
 #include "Scene.h"
@@ -7,6 +6,7 @@
 #include "FireBall.h"
 #include "Effect.h"
 #include "NameGenerator.h"
+#include "SimulationClock.h"
 
 namespace islands {
 
@@ -55,8 +55,6 @@ void Player::start() {
 }
 
 void Player::update() {
-	Camera::getInstance().lookAt(getEntity().getPosition());
-
 	if (status_ == State::Dead) {
 		return;
 	} else if (health_->isDead()) {
@@ -101,7 +99,7 @@ void Player::update() {
 	case State::Idling: {
 		if (Input::getInstance().isCommandActive(Input::Command::Attack)) {
 			status_ = State::PreFire;
-			attackAnimStartedAt_ = glfwGetTime();
+			attackAnimStartedAt_ = SimulationClock::getInstance().getTime();
 			drawer_->enableAnimation("Armature|Attack", false, ATTACK_ANIM_SPEED);
 		}
 		break;
@@ -110,7 +108,7 @@ void Player::update() {
 		getEntity().setQuaternion(geometry::directionToQuaternion(u, {1.f, 0, 0}));
 		break;
 	case State::PreFire:
-		if (glfwGetTime() > attackAnimStartedAt_ + 20.0 / ATTACK_ANIM_SPEED) {
+		if (SimulationClock::getInstance().getTime() > attackAnimStartedAt_ + 20.0 / ATTACK_ANIM_SPEED) {
 			status_ = State::PostFire;
 			getChunk().createEntity(
 				NameGenerator::generate("FireBall"))->createComponent<FireBall>(
@@ -118,7 +116,7 @@ void Player::update() {
 		}
 		break;
 	case State::PostFire:
-		if (glfwGetTime() > attackAnimStartedAt_ + 35.0 / ATTACK_ANIM_SPEED) {
+		if (SimulationClock::getInstance().getTime() > attackAnimStartedAt_ + 35.0 / ATTACK_ANIM_SPEED) {
 			status_ = State::Idling;
 			drawer_->stopAnimation();
 		}
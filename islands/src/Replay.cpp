@@ -0,0 +1,226 @@
+#include "Replay.h"
+#include "Log.h"
+
+namespace islands {
+
+namespace {
+
+const char MAGIC[] = {'I', 'R', 'P', 'L'};
+constexpr std::uint32_t VERSION = 3;
+
+template <class T>
+void write(std::ostream& os, const T& value) {
+	os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T read(std::istream& is) {
+	T value;
+	is.read(reinterpret_cast<char*>(&value), sizeof(T));
+	if (!is) {
+		throw std::runtime_error("truncated replay");
+	}
+	return value;
+}
+
+}
+
+Replay::Replay() :
+	mode_(Mode::None),
+	frameIndex_(0),
+	tickCommandIndex_(0),
+	seedIndex_(0),
+	tickIndex_(0),
+	diverged_(false) {}
+
+Replay::~Replay() {
+	stop();
+}
+
+Replay& Replay::getInstance() {
+	static Replay instance;
+	return instance;
+}
+
+void Replay::startRecording(const std::string& filename) {
+	stop();
+
+	SLOG << "Replay: Recording to " << filename << std::endl;
+	mode_ = Mode::Record;
+	filename_ = filename;
+	frames_.clear();
+	tickCommands_.clear();
+	seeds_.clear();
+	stateHashes_.clear();
+}
+
+void Replay::startPlayback(const std::string& filename) {
+	stop();
+
+	SLOG << "Replay: Playing " << filename << std::endl;
+	std::ifstream ifs(filename, std::ios::binary);
+	if (!ifs) {
+		throw std::runtime_error("failed to open replay");
+	}
+
+	char magic[sizeof(MAGIC)];
+	ifs.read(magic, sizeof(magic));
+	if (!ifs || !std::equal(magic, magic + sizeof(magic), MAGIC) || read<std::uint32_t>(ifs) != VERSION) {
+		throw std::runtime_error("not a replay");
+	}
+
+	frames_.resize(read<std::uint32_t>(ifs));
+	for (auto& frame : frames_) {
+		frame.deltaTime = read<float>(ifs);
+		frame.input.direction.x = read<float>(ifs);
+		frame.input.direction.y = read<float>(ifs);
+		frame.input.commands = 0;
+		const auto buttons = read<std::uint8_t>(ifs);
+		frame.input.anyButtonPressed = (buttons & 1) != 0;
+		frame.input.anyButtonExceptArrowPressed = (buttons & 2) != 0;
+	}
+	tickCommands_.resize(read<std::uint32_t>(ifs));
+	for (auto& commands : tickCommands_) {
+		commands = read<Input::CommandMask>(ifs);
+	}
+	seeds_.resize(read<std::uint32_t>(ifs));
+	for (auto& seed : seeds_) {
+		seed = read<std::uint32_t>(ifs);
+	}
+	stateHashes_.resize(read<std::uint32_t>(ifs));
+	for (auto& hash : stateHashes_) {
+		hash = read<std::uint64_t>(ifs);
+	}
+
+	mode_ = Mode::Play;
+	frameIndex_ = tickCommandIndex_ = seedIndex_ = tickIndex_ = 0;
+	diverged_ = false;
+}
+
+void Replay::stop() {
+	if (mode_ == Mode::Record) {
+		SLOG << "Replay: Writing " << frames_.size() << " frames to " << filename_ << std::endl;
+		std::ofstream ofs(filename_, std::ios::binary);
+		ofs.write(MAGIC, sizeof(MAGIC));
+		write(ofs, VERSION);
+		write(ofs, static_cast<std::uint32_t>(frames_.size()));
+		for (const auto& frame : frames_) {
+			write(ofs, frame.deltaTime);
+			write(ofs, frame.input.direction.x);
+			write(ofs, frame.input.direction.y);
+			write(ofs, static_cast<std::uint8_t>(
+				(frame.input.anyButtonPressed ? 1 : 0) | (frame.input.anyButtonExceptArrowPressed ? 2 : 0)));
+		}
+		write(ofs, static_cast<std::uint32_t>(tickCommands_.size()));
+		for (const auto commands : tickCommands_) {
+			write(ofs, commands);
+		}
+		write(ofs, static_cast<std::uint32_t>(seeds_.size()));
+		for (const auto seed : seeds_) {
+			write(ofs, seed);
+		}
+		write(ofs, static_cast<std::uint32_t>(stateHashes_.size()));
+		for (const auto hash : stateHashes_) {
+			write(ofs, hash);
+		}
+	}
+
+	mode_ = Mode::None;
+	frames_.clear();
+	tickCommands_.clear();
+	seeds_.clear();
+	stateHashes_.clear();
+}
+
+Replay::Mode Replay::getMode() const {
+	return mode_;
+}
+
+float Replay::processDeltaTime(float deltaTime) {
+	switch (mode_) {
+	case Mode::Record:
+		frames_.push_back({deltaTime, Input::State{}});
+		break;
+	case Mode::Play:
+		if (frameIndex_ < frames_.size()) {
+			return frames_[frameIndex_++].deltaTime;
+		}
+		finishPlayback();
+		break;
+	default:
+		break;
+	}
+	return deltaTime;
+}
+
+void Replay::processInput(Input::State& state) {
+	if (frames_.empty()) {
+		return;
+	}
+	switch (mode_) {
+	case Mode::Record:
+		frames_.back().input = state;
+		break;
+	case Mode::Play:
+		if (frameIndex_ > 0) {
+			state = frames_[frameIndex_ - 1].input;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void Replay::processTickCommands(Input::CommandMask& commands) {
+	switch (mode_) {
+	case Mode::Record:
+		tickCommands_.emplace_back(commands);
+		break;
+	case Mode::Play:
+		commands = tickCommandIndex_ < tickCommands_.size() ? tickCommands_[tickCommandIndex_++] : 0;
+		break;
+	default:
+		break;
+	}
+}
+
+std::uint32_t Replay::generateSeed() {
+	if (mode_ == Mode::Play) {
+		if (seedIndex_ < seeds_.size()) {
+			return seeds_[seedIndex_++];
+		}
+		SLOG << "Replay: Ran out of seeds" << std::endl;
+	}
+
+	std::random_device randomDevice;
+	const auto seed = randomDevice();
+	if (mode_ == Mode::Record) {
+		seeds_.emplace_back(seed);
+	}
+	return seed;
+}
+
+void Replay::processStateHash(std::uint64_t hash) {
+	switch (mode_) {
+	case Mode::Record:
+		stateHashes_.emplace_back(hash);
+		break;
+	case Mode::Play:
+		if (tickIndex_ < stateHashes_.size() && stateHashes_[tickIndex_] != hash && !diverged_) {
+			SLOG << "Replay: Diverged from the recording at tick " << tickIndex_ << std::endl;
+			diverged_ = true;
+		}
+		++tickIndex_;
+		break;
+	default:
+		break;
+	}
+}
+
+void Replay::finishPlayback() {
+	SLOG << "Replay: Finished playing " << frames_.size() << " frames, "
+		<< (diverged_ ? "diverged" : "matched the recording") << std::endl;
+	stop();
+}
+
+}
@@ -6,17 +6,17 @@ namespace islands {
 
 Resource::Resource() : Resource(NameGenerator::generate("resource")) {}
 
-Resource::Resource(const std::string& name) :
+Resource::Resource(const Name& name) :
 	name_(name),
 	status_(State::Unloaded) {}
 
 const std::string& Resource::getName() const {
-	return name_;
+	return name_.str();
 }
 
 void Resource::load() {
 	if (status_ == State::Unloaded) {
-		SLOG << "Loading " << getName() << std::endl;
+		SLOG << "Loading " << name_ << std::endl;
 		loadImpl();
 		status_ = State::Loaded;
 	}
@@ -26,7 +26,7 @@ void Resource::upload() {
 	if (status_ != State::Uploaded) {
 		load();
 
-		SLOG << "Uploading " << getName() << std::endl;
+		SLOG << "Uploading " << name_ << std::endl;
 		uploadImpl();
 		status_ = State::Uploaded;
 	}
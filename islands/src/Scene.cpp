@@ -96,7 +96,7 @@ void SceneManager::draw() {
 
 void SceneManager::fadeInOut() {
 	transition_.status = TransitionState::FadeOut;
-	transition_.startedAt = glfwGetTime();
+	transition_.startedAt = Window::getInstance().getTime();
 }
 
 std::shared_ptr<Scene> SceneManager::getPreviousScene() const {
@@ -105,7 +105,7 @@ std::shared_ptr<Scene> SceneManager::getPreviousScene() const {
 }
 
 double SceneManager::Transition::getProgress() {
-	return (glfwGetTime() - startedAt) / 0.5;
+	return (Window::getInstance().getTime() - startedAt) / 0.5;
 }
 
 TitleScene::TitleScene() :
@@ -148,7 +148,7 @@ void TitleScene::draw() {
 	titleProgram_->setUniform("size", glm::one<glm::vec2>());
 	titleProgram_->setUniform("tex", static_cast<GLuint>(0));
 	titleProgram_->setUniform("selectedItem", selectedItem_);
-	titleProgram_->setUniform("time", static_cast<glm::float32>(glfwGetTime()));
+	titleProgram_->setUniform("time", static_cast<glm::float32>(Window::getInstance().getTime()));
 	titleTexture_->bind(0);
 
 	glDisable(GL_DEPTH_TEST);
@@ -224,7 +224,7 @@ void LevelSelectionScene::draw() {
 		seaImage_.draw();
 		break;
 	default:
-		throw std::exception("unreachable");
+		throw std::logic_error("unreachable");
 	}
 }
 
@@ -244,7 +244,7 @@ void CreditScene::draw() {
 
 GameOverScene::GameOverScene() :
 	gameOverImage_(Texture2D::createOrGet("game_over.png")),
-	startedAt_(glfwGetTime()) {
+	startedAt_(Window::getInstance().getTime()) {
 
 	Sound::createOrGet("game_over.ogg")->createInstance()->play();
 }
@@ -253,7 +253,7 @@ void GameOverScene::update() {
 	if (Input::getInstance().anyButtonPressed()) {
 		SceneManager::getInstance().changeScene<TitleScene>();
 	}
-	gameOverImage_.setAlpha(static_cast<float>(glfwGetTime() - startedAt_));
+	gameOverImage_.setAlpha(static_cast<float>(Window::getInstance().getTime() - startedAt_));
 }
 
 void GameOverScene::draw() {
@@ -263,7 +263,7 @@ void GameOverScene::draw() {
 
 GameClearScene::GameClearScene() :
 	gameClearImage_(Texture2D::createOrGet("game_clear.png")),
-	startedAt_(glfwGetTime()) {
+	startedAt_(Window::getInstance().getTime()) {
 
 	Sound::createOrGet("game_clear.ogg")->createInstance()->play();
 }
@@ -272,7 +272,7 @@ void GameClearScene::update() {
 	if (Input::getInstance().anyButtonPressed()) {
 		SceneManager::getInstance().changeScene<TitleScene>();
 	}
-	gameClearImage_.setAlpha(static_cast<float>(glfwGetTime() - startedAt_));
+	gameClearImage_.setAlpha(static_cast<float>(Window::getInstance().getTime() - startedAt_));
 }
 
 void GameClearScene::draw() {
@@ -65,7 +65,7 @@ GLenum Shader::toGLenum(const Type& type) {
 	case Type::Fragment:
 		return GL_FRAGMENT_SHADER;
 	default:
-		throw std::exception("unreachable");
+		throw std::logic_error("unreachable");
 	}
 }
 
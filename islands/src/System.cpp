@@ -5,6 +5,12 @@
 #include <mmsystem.h>
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <glfw3native.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
 #endif
 
 namespace islands {
@@ -75,7 +81,7 @@ void disableIME(GLFWwindow* window) {
 #ifdef _WIN32
 	ImmAssociateContext(glfwGetWin32Window(window), NULL);
 #else
-#error not implemented
+	UNUSED(window);
 #endif
 }
 
@@ -85,7 +91,7 @@ void sleep(std::chrono::milliseconds duration) {
 	Sleep(static_cast<DWORD>(duration.count()));
 	timeEndPeriod(1);
 #else
-#error not implemented
+	std::this_thread::sleep_for(duration);
 #endif
 }
 
@@ -97,9 +103,83 @@ MemoryStatus getPhysicalMemoryStatus() {
 	GlobalMemoryStatusEx(&stat);
 	return MemoryStatus{stat.ullAvailPhys, stat.ullTotalPhys};
 #else
-#error not implemented
+	const auto pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+	return MemoryStatus{
+		pageSize * static_cast<uint64_t>(sysconf(_SC_AVPHYS_PAGES)),
+		pageSize * static_cast<uint64_t>(sysconf(_SC_PHYS_PAGES))
+	};
 #endif
 }
 
+MappedFile::MappedFile(const std::string& filename) :
+	data_(nullptr),
+	size_(0) {
+
+#ifdef _WIN32
+	mapping_ = nullptr;
+	file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+		return;
+	}
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_) {
+		return;
+	}
+	data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_) {
+		size_ = static_cast<size_t>(size.QuadPart);
+	}
+#else
+	const auto fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		const auto data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			data_ = static_cast<const char*>(data);
+			size_ = static_cast<size_t>(st.st_size);
+		}
+	}
+	close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_) {
+		CloseHandle(mapping_);
+	}
+	if (file_ != INVALID_HANDLE_VALUE) {
+		CloseHandle(file_);
+	}
+#else
+	if (data_) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+#endif
+}
+
+bool MappedFile::isOpen() const {
+	return data_ != nullptr;
+}
+
+const char* MappedFile::getData() const {
+	return data_;
+}
+
+size_t MappedFile::getSize() const {
+	return size_;
+}
+
 }
 }
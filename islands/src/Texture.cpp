@@ -74,7 +74,7 @@ void Texture2D::uploadImpl() {
 		format = GL_RGBA;
 		break;
 	default:
-		throw std::exception("not supported");
+		throw std::runtime_error("not supported");
 	}
 	glTexImage2D(GL_TEXTURE_2D, 0, format, width_, height_, 0, format, GL_UNSIGNED_BYTE, data_);
 
@@ -0,0 +1,108 @@
+#include "TransformStore.h"
+
+namespace islands {
+
+TransformStore::Index TransformStore::create() {
+	Index index;
+	if (freeIndices_.empty()) {
+		index = static_cast<Index>(positions_.size());
+		positions_.emplace_back(0);
+		quaternions_.emplace_back(1, 0, 0, 0);
+		scales_.emplace_back(1);
+		modelMatrices_.emplace_back(1.f);
+		versions_.emplace_back(0);
+		dirty_.emplace_back(0);
+	} else {
+		index = freeIndices_.back();
+		freeIndices_.pop_back();
+		positions_[index] = glm::vec3(0);
+		quaternions_[index] = glm::quat(1, 0, 0, 0);
+		scales_[index] = glm::vec3(1);
+		modelMatrices_[index] = glm::mat4(1.f);
+		++versions_[index];
+		dirty_[index] = 0;
+	}
+	return index;
+}
+
+void TransformStore::destroy(Index index) {
+	assert(index < positions_.size());
+
+	// a pending entry in dirtyIndices_ just rebuilds an unused matrix
+	freeIndices_.emplace_back(index);
+}
+
+void TransformStore::setPosition(Index index, const glm::vec3& position) {
+	if (position != positions_[index]) {
+		positions_[index] = position;
+		markDirty(index);
+	}
+}
+
+const glm::vec3& TransformStore::getPosition(Index index) const {
+	return positions_[index];
+}
+
+void TransformStore::setQuaternion(Index index, const glm::quat& quaternion) {
+	if (quaternion != quaternions_[index]) {
+		quaternions_[index] = quaternion;
+		markDirty(index);
+	}
+}
+
+const glm::quat& TransformStore::getQuaternion(Index index) const {
+	return quaternions_[index];
+}
+
+void TransformStore::setScale(Index index, const glm::vec3& scale) {
+	if (scale != scales_[index]) {
+		scales_[index] = scale;
+		markDirty(index);
+	}
+}
+
+const glm::vec3& TransformStore::getScale(Index index) const {
+	return scales_[index];
+}
+
+const glm::mat4& TransformStore::getModelMatrix(Index index) {
+	if (dirty_[index]) {
+		updateMatrix(index);
+	}
+	return modelMatrices_[index];
+}
+
+TransformStore::Version TransformStore::getVersion(Index index) const {
+	return versions_[index];
+}
+
+void TransformStore::updateMatrices() {
+	for (const auto index : dirtyIndices_) {
+		if (dirty_[index]) {
+			updateMatrix(index);
+		}
+	}
+	dirtyIndices_.clear();
+}
+
+void TransformStore::markDirty(Index index) {
+	++versions_[index];
+	if (!dirty_[index]) {
+		dirty_[index] = 1;
+		dirtyIndices_.emplace_back(index);
+	}
+}
+
+void TransformStore::updateMatrix(Index index) {
+	// translate(position) * mat4_cast(quaternion) * scale(scale) without the matrix products
+	const glm::mat3 rotation = glm::mat3_cast(quaternions_[index]);
+	const auto& scale = scales_[index];
+	auto& m = modelMatrices_[index];
+	m[0] = glm::vec4(rotation[0] * scale.x, 0);
+	m[1] = glm::vec4(rotation[1] * scale.y, 0);
+	m[2] = glm::vec4(rotation[2] * scale.z, 0);
+	m[3] = glm::vec4(positions_[index], 1);
+	dirty_[index] = 0;
+}
+
+}
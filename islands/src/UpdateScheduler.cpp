@@ -0,0 +1,74 @@
+#include "UpdateScheduler.h"
+#include "Component.h"
+#include "Profiler.h"
+
+namespace islands {
+
+void UpdateScheduler::add(std::shared_ptr<Component> component, std::uint32_t typeId,
+	UpdateFunction updateFunction, UpdatePhase phase) {
+
+	// Component::startAndUpdate rejects the types of this phase that override start(),
+	// which would never run
+	if (phase == UpdatePhase::Physics) {
+		return;
+	}
+
+	if (typeId >= groupLocations_.size()) {
+		groupLocations_.resize(typeId + 1, GroupLocation{NUM_PHASES, 0});
+	}
+
+	auto& location = groupLocations_[typeId];
+	if (location.phase == NUM_PHASES) {
+		location.phase = static_cast<size_t>(phase);
+		location.index = phases_[location.phase].size();
+		phases_[location.phase].push_back({typeId, updateFunction, {}});
+	}
+	auto& group = phases_[location.phase][location.index];
+	assert(group.updateFunction == updateFunction);
+	group.components.emplace_back(component);
+}
+
+void UpdateScheduler::update() {
+	clean();
+
+	for (size_t phase = 0; phase < NUM_PHASES; ++phase) {
+#ifdef _DEBUG
+		Profiler::getInstance().enterSection(getPhaseName(phase));
+#endif
+
+		// indices rather than iterators since updates can add groups and components
+		const auto& groups = phases_[phase];
+		for (size_t g = 0; g < groups.size(); ++g) {
+			const auto updateFunction = groups[g].updateFunction;
+			for (size_t i = 0; i < groups[g].components.size(); ++i) {
+				const auto component = groups[g].components[i];
+				if (!component->isDestroyed()) {
+					updateFunction(*component);
+				}
+			}
+		}
+
+#ifdef _DEBUG
+		Profiler::getInstance().leaveSection(getPhaseName(phase));
+#endif
+	}
+}
+
+const char* UpdateScheduler::getPhaseName(size_t phase) {
+	static const std::array<const char*, NUM_PHASES> NAMES = {{"logic", "effect", "presentation"}};
+	return NAMES.at(phase);
+}
+
+void UpdateScheduler::clean() {
+	for (auto& groups : phases_) {
+		for (auto& group : groups) {
+			auto& components = group.components;
+			components.erase(std::remove_if(components.begin(), components.end(),
+				[](const std::shared_ptr<Component>& c) {
+				return c->isDestroyed() || c->getEntity().isDestroyed();
+			}), components.end());
+		}
+	}
+}
+
+}
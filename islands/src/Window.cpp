@@ -1,6 +1,7 @@
 #include "Window.h"
 #include "Log.h"
 #include "Version.h"
+#include "Replay.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
@@ -9,13 +10,15 @@ namespace islands {
 
 Window::Window() :
 	lastUpdateTime_(0.0),
-	deltaTime_(0.0) {
+	deltaTime_(0.f),
+	time_(0.0) {
 
 	SLOG << "GLFW: Creating window" << std::endl;
 	std::stringstream ss;
 	ss << APP_NAME << " v" << VERSION_MAJOR << "." << VERSION_MINOR;
 	window_ = glfwCreateWindow(1280, 720, ss.str().c_str(), nullptr, nullptr);
 	glfwMakeContextCurrent(window_);
+	glfwSwapInterval(1);
 
 	SLOG << "glad: Loading" << std::endl;
 	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
@@ -61,17 +64,13 @@ bool Window::update() {
 	glfwSwapBuffers(window_);
 	glfwPollEvents();
 
-	constexpr auto TARGET_DELTA_TIME = 1.0 / 60;
 	constexpr auto MAX_DELTA_TIME = 1.0 / 15;
 
-	const auto sleepDuration = 1000 * (TARGET_DELTA_TIME - glfwGetTime() + lastUpdateTime_);
-	if (sleepDuration > 0) {
-		sys::sleep(std::chrono::milliseconds(static_cast<unsigned long>(sleepDuration)));
-	}
-
 	const auto now = glfwGetTime();
-	deltaTime_ = static_cast<float>(std::min(MAX_DELTA_TIME, now - lastUpdateTime_));
+	deltaTime_ = Replay::getInstance().processDeltaTime(
+		static_cast<float>(std::min(MAX_DELTA_TIME, now - lastUpdateTime_)));
 	lastUpdateTime_ = now;
+	time_ += deltaTime_;
 
 	return true;
 }
@@ -88,6 +87,10 @@ float Window::getDeltaTime() const {
 	return deltaTime_;
 }
 
+double Window::getTime() const {
+	return time_;
+}
+
 void Window::saveScreenShot(const char* filename) const {
 	static constexpr int numComponents = 3;
 
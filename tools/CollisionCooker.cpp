@@ -0,0 +1,157 @@
+#include "BVH.h"
+
+#include <set>
+
+using namespace islands::geometry;
+
+namespace {
+
+picojson::value readJSON(const std::string& filePath) {
+	std::ifstream ifs(filePath);
+	if (!ifs) {
+		throw std::invalid_argument("cannot open " + filePath);
+	}
+	picojson::value json;
+	ifs >> json;
+	return json;
+}
+
+// mesh names of the collision entries which become MeshColliders in loadChunk()
+std::set<std::string> collectCollisionMeshes(const std::string& levelDir, const std::string& levelFilename) {
+	std::set<std::string> meshNames;
+	const auto level = readJSON(levelDir + '/' + levelFilename);
+	for (const auto& item : level.get("chunks").get<picojson::array>()) {
+		const auto& chunkFilename = item.get<picojson::object>().at("filename").get<std::string>();
+		const auto chunk = readJSON(levelDir + '/' + chunkFilename);
+		for (const auto& ent : chunk.get("entities").get<picojson::object>()) {
+			const auto& prop = ent.second.get<picojson::object>();
+			const auto iter = prop.find("collision");
+			if (iter == prop.end() || !iter->second.is<picojson::object>()) {
+				continue;
+			}
+			const auto& collisionProp = iter->second.get<picojson::object>();
+			const auto& type = collisionProp.at("type").get<std::string>();
+			if (type == "mesh" || type == "wall") {
+				meshNames.emplace(collisionProp.at("mesh_name").get<std::string>());
+			}
+		}
+	}
+	return meshNames;
+}
+
+std::vector<char> readFile(const std::string& filePath) {
+	std::ifstream ifs(filePath, std::ios::binary);
+	if (!ifs) {
+		throw std::invalid_argument("cannot open " + filePath);
+	}
+	return std::vector<char>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+// whether filePath holds a valid BVH cooked from a source with the given checksum
+bool isUpToDate(const std::string& filePath, std::uint64_t sourceChecksum) {
+	std::ifstream ifs(filePath, std::ios::binary);
+	if (!ifs) {
+		return false;
+	}
+	const auto data = std::make_shared<std::vector<char>>(
+		std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	try {
+		const BVH bvh(std::shared_ptr<const char>(data, data->data()), data->size());
+		return bvh.getSourceChecksum() == sourceChecksum;
+	} catch (const std::invalid_argument&) {
+		return false;
+	}
+}
+
+// same triangles as Model::getCollisionBVH() builds from the meshes loaded by Model::loadImpl,
+// which also drops the degenerate ones, whose normals would be NaN
+std::vector<Triangle> loadTriangles(const std::string& filePath, size_t& numDegenerate) {
+	static const auto FLAGS = aiProcess_GenNormals | aiProcess_ImproveCacheLocality |
+		aiProcess_JoinIdenticalVertices | aiProcess_LimitBoneWeights | aiProcess_OptimizeMeshes |
+		aiProcess_RemoveComponent | aiProcess_Triangulate;
+	Assimp::Importer importer;
+	importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_CAMERAS | aiComponent_LIGHTS);
+	const auto scene = importer.ReadFile(filePath, FLAGS);
+	if (!scene) {
+		throw std::invalid_argument(importer.GetErrorString());
+	}
+
+	std::vector<Triangle> triangles;
+	numDegenerate = 0;
+	for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+		const auto mesh = scene->mMeshes[i];
+		const auto vertex = [mesh](unsigned int index) {
+			const auto& v = mesh->mVertices[index];
+			return glm::vec3(v.x, v.y, v.z);
+		};
+		for (unsigned int j = 0; j < mesh->mNumFaces; ++j) {
+			const auto& face = mesh->mFaces[j];
+			if (face.mNumIndices != 3) {
+				continue;
+			}
+			const Triangle triangle{vertex(face.mIndices[0]), vertex(face.mIndices[1]), vertex(face.mIndices[2])};
+			if (triangle.isDegenerate()) {
+				++numDegenerate;
+			} else {
+				triangles.push_back(triangle);
+			}
+		}
+	}
+	return triangles;
+}
+
+}
+
+// writes asset/collision/<mesh name>.bvh for every collision mesh of the given levels,
+// skipping those already cooked from the current version of their mesh.
+// the game maps the blobs without looking at the meshes, so this is where stale blobs get replaced
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::cerr << "usage: " << argv[0] << " ASSET_DIR LEVEL.json..." << std::endl;
+		return 1;
+	}
+	const std::string assetDir = argv[1];
+
+	std::set<std::string> meshNames;
+	for (int i = 2; i < argc; ++i) {
+		const auto names = collectCollisionMeshes(assetDir + "/level", argv[i]);
+		meshNames.insert(names.begin(), names.end());
+	}
+
+	int status = 0;
+	for (const auto& name : meshNames) {
+		try {
+			const auto meshPath = assetDir + "/mesh/" + name;
+			const auto outPath = assetDir + "/collision/" + name + ".bvh";
+			const auto source = readFile(meshPath);
+			const auto sourceChecksum = calculateChecksum(source.data(), source.size());
+			if (isUpToDate(outPath, sourceChecksum)) {
+				std::cout << name << ": up to date" << std::endl;
+				continue;
+			}
+
+			size_t numDegenerate;
+			const auto triangles = loadTriangles(meshPath, numDegenerate);
+			if (numDegenerate > 0) {
+				std::cout << name << ": " << numDegenerate << " degenerate triangles dropped" << std::endl;
+			}
+			if (triangles.empty()) {
+				std::cout << name << ": no triangles, skipped" << std::endl;
+				continue;
+			}
+			const BVH bvh(triangles);
+
+			std::ofstream ofs(outPath, std::ios::binary);
+			if (!ofs) {
+				throw std::invalid_argument("cannot write " + outPath);
+			}
+			bvh.write(ofs, sourceChecksum);
+			std::cout << name << ": " << triangles.size() << " triangles, "
+				<< bvh.getNumNodes() << " nodes -> " << outPath << std::endl;
+		} catch (const std::exception& e) {
+			std::cerr << name << ": " << e.what() << std::endl;
+			status = 1;
+		}
+	}
+	return status;
+}